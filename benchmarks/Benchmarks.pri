@@ -0,0 +1,16 @@
+CONFIG += qt warn_on c++17 console testcase
+CONFIG -= app_bundle
+
+QT += testlib concurrent
+QT -= gui
+
+INCLUDEPATH += \
+    $$PWD/../src/cache \
+    $$PWD/../src/git
+
+DEFINES += \
+   QT_NO_JAVA_STYLE_ITERATORS \
+   QT_NO_CAST_TO_ASCII \
+   QT_RESTRICTED_CAST_FROM_ASCII \
+   QT_DISABLE_DEPRECATED_BEFORE=0x050900 \
+   QT_USE_QSTRINGBUILDER
@@ -0,0 +1,18 @@
+TARGET = GitLogParserBenchmark
+
+include(../Benchmarks.pri)
+
+HEADERS += \
+    $$PWD/../../src/cache/CommitInfo.h \
+    $$PWD/../../src/cache/CommitOid.h \
+    $$PWD/../../src/cache/Lane.h \
+    $$PWD/../../src/cache/References.h \
+    $$PWD/../../src/git/GitLogParser.h
+
+SOURCES += \
+    $$PWD/GitLogParserBenchmark.cpp \
+    $$PWD/../../src/cache/CommitInfo.cpp \
+    $$PWD/../../src/cache/CommitOid.cpp \
+    $$PWD/../../src/cache/Lane.cpp \
+    $$PWD/../../src/cache/References.cpp \
+    $$PWD/../../src/git/GitLogParser.cpp
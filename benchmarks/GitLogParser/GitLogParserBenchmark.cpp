@@ -0,0 +1,167 @@
+#include <CommitInfo.h>
+#include <GitLogParser.h>
+
+#include <QtTest>
+
+namespace
+{
+const int DEFAULT_COMMITS = 1000000;
+
+QByteArray shaOf(int commit)
+{
+   return QByteArray::number(commit, 16).rightJustified(CommitOid::HEX_LENGTH, 'a');
+}
+
+// The parser of the records as it was before GitLogParser: every record is decoded to a QString and split in lines.
+CommitInfo parseLegacyRecord(const QByteArray &commitData)
+{
+   if (const auto fields = QString::fromUtf8(commitData).split('\n'); fields.count() > 6)
+   {
+      const auto firstField = fields.constFirst();
+      const auto isSigned = !fields.first().isEmpty() && !firstField.contains("log size") ? true : false;
+      auto combinedShas = fields.at(1);
+      auto commitSha = combinedShas.split('X').first();
+      const auto boundary = commitSha[0];
+      const auto sha = commitSha.remove(0, 1);
+      combinedShas = combinedShas.remove(0, sha.size() + 1 + 1).trimmed();
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+      const auto parentsSha = combinedShas.split(' ', Qt::SkipEmptyParts);
+#else
+      const auto parentsSha = combinedShas.split(' ', QString::SkipEmptyParts);
+#endif
+      const auto committer = fields.at(2);
+      const auto author = fields.at(3);
+      const auto commitDate = QDateTime::fromSecsSinceEpoch(fields.at(4).toInt());
+      const auto shortLog = fields.at(5);
+      QString longLog;
+
+      for (auto i = 6; i < fields.count(); ++i)
+         longLog += fields.at(i) + '\n';
+
+      longLog = longLog.trimmed();
+
+      return CommitInfo { sha,    parentsSha, boundary, committer, commitDate,
+                          author, shortLog,   longLog,  isSigned,  isSigned ? firstField : QString() };
+   }
+
+   return CommitInfo();
+}
+}
+
+class GitLogParserBenchmark : public QObject
+{
+   Q_OBJECT
+
+private slots:
+   void initTestCase();
+   void legacyParser();
+   void sequentialParser();
+   void parallelParser();
+   void parallelRecords();
+
+private:
+   int mCommits = 0;
+   QByteArray mLog;
+};
+
+void GitLogParserBenchmark::initTestCase()
+{
+   mCommits = qEnvironmentVariableIsSet("GQ_BENCHMARK_COMMITS") ? qEnvironmentVariableIntValue("GQ_BENCHMARK_COMMITS")
+                                                                : DEFAULT_COMMITS;
+
+   // The same output `git log -z --log-size --parents` gives with the format of GitRepoLoader. One commit of every ten
+   // is a merge.
+   for (auto i = mCommits - 1; i >= 0; --i)
+   {
+      QByteArray record;
+      record.append(">").append(shaOf(i)).append("X");
+
+      if (i > 0)
+         record.append(shaOf(i - 1));
+
+      if (i > 1 && i % 10 == 0)
+         record.append(" ").append(shaOf(i - 2));
+
+      record.append("\nCommitter Name<committer@gitqlient.org>\nAuthor Name<author@gitqlient.org>\n")
+          .append(QByteArray::number(1600000000 + i))
+          .append("\nSubject of the commit number ")
+          .append(QByteArray::number(i))
+          .append("\nFirst line of the body.\n\nSecond paragraph of the body with some more text in it.\n ");
+
+      mLog.append("log size ").append(QByteArray::number(record.size())).append("\n").append(record);
+
+      if (i > 0)
+         mLog.append('\000');
+   }
+}
+
+void GitLogParserBenchmark::legacyParser()
+{
+   QList<CommitInfo> commits;
+
+   QBENCHMARK_ONCE
+   {
+      const auto records = mLog.split('\000');
+
+      for (const auto &record : records)
+      {
+         if (auto commit = parseLegacyRecord(record); commit.isValid())
+            commits.append(std::move(commit));
+      }
+   }
+
+   QCOMPARE(commits.count(), mCommits);
+}
+
+void GitLogParserBenchmark::sequentialParser()
+{
+   QList<CommitInfo> commits;
+
+   QBENCHMARK_ONCE
+   {
+      for (auto start = 0; start < mLog.size();)
+      {
+         auto end = mLog.indexOf('\000', start);
+
+         if (end == -1)
+            end = mLog.size();
+
+         if (auto commit = GitLogParser::parseRecord(mLog.constData() + start, end - start); commit.isValid())
+            commits.append(std::move(commit));
+
+         start = end + 1;
+      }
+   }
+
+   QCOMPARE(commits.count(), mCommits);
+}
+
+void GitLogParserBenchmark::parallelParser()
+{
+   QList<CommitInfo> commits;
+
+   QBENCHMARK_ONCE
+   {
+      commits = GitLogParser::parseLog(mLog);
+   }
+
+   QCOMPARE(commits.count(), mCommits);
+}
+
+void GitLogParserBenchmark::parallelRecords()
+{
+   // The signed log is split in records before they are parsed, so the split is not part of the measure.
+   const auto records = mLog.split('\000').toVector();
+   QList<CommitInfo> commits;
+
+   QBENCHMARK_ONCE
+   {
+      commits = GitLogParser::parseRecords(records);
+   }
+
+   QCOMPARE(commits.count(), mCommits);
+}
+
+QTEST_APPLESS_MAIN(GitLogParserBenchmark)
+
+#include "GitLogParserBenchmark.moc"
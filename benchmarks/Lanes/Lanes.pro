@@ -0,0 +1,15 @@
+TARGET = LanesBenchmark
+
+include(../Benchmarks.pri)
+
+HEADERS += \
+    $$PWD/LegacyLanes.h \
+    $$PWD/../../src/cache/Lane.h \
+    $$PWD/../../src/cache/LaneType.h \
+    $$PWD/../../src/cache/lanes.h
+
+SOURCES += \
+    $$PWD/LanesBenchmark.cpp \
+    $$PWD/LegacyLanes.cpp \
+    $$PWD/../../src/cache/Lane.cpp \
+    $$PWD/../../src/cache/lanes.cpp
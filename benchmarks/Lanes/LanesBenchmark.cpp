@@ -0,0 +1,150 @@
+#include "LegacyLanes.h"
+
+#include <lanes.h>
+
+#include <QtTest>
+
+namespace
+{
+const int DEFAULT_COMMITS = 200000;
+const int BRANCHES = 200;
+const int MERGE_INTERVAL = 50;
+
+QString shaOf(int commit)
+{
+   return QString::number(commit, 16).rightJustified(40, 'a');
+}
+
+// The step GitCache did for every commit before the lanes were matched by commit index.
+QVector<Lane> calculateLegacyLanes(LegacyLanes &lanes, const QString &sha, const QStringList &parents)
+{
+   bool isDiscontinuity;
+   bool isFork = lanes.isFork(sha, isDiscontinuity);
+   bool isMerge = parents.count() > 1;
+
+   if (isDiscontinuity)
+      lanes.changeActiveLane(sha);
+
+   if (isFork)
+      lanes.setFork(sha);
+   if (isMerge)
+      lanes.setMerge(parents);
+   if (parents.isEmpty())
+      lanes.setInitial();
+
+   const auto commitLanes = lanes.getLanes();
+
+   lanes.nextParent(parents.isEmpty() ? QString() : parents.first());
+
+   if (isMerge)
+      lanes.afterMerge();
+   if (isFork)
+      lanes.afterFork();
+   if (lanes.isBranch())
+      lanes.afterBranch();
+
+   return commitLanes;
+}
+
+qint64 checksum(const QVector<Lane> &lanes)
+{
+   qint64 sum = lanes.count();
+
+   for (const auto &lane : lanes)
+      sum += static_cast<int>(lane.getType());
+
+   return sum;
+}
+}
+
+class LanesBenchmark : public QObject
+{
+   Q_OBJECT
+
+private slots:
+   void initTestCase();
+   void legacyLanes();
+   void indexLanes();
+
+private:
+   int mCommits = 0;
+   QVector<Lanes::Parents> mParents;
+   QVector<QString> mShas;
+   QVector<QStringList> mParentShas;
+   qint64 mLegacyChecksum = -1;
+};
+
+void LanesBenchmark::initTestCase()
+{
+   mCommits = qEnvironmentVariableIsSet("GQ_BENCHMARK_COMMITS") ? qEnvironmentVariableIntValue("GQ_BENCHMARK_COMMITS")
+                                                                : DEFAULT_COMMITS;
+
+   // A root commit with 200 branches that grow at the same time, so the graph has 200 lanes in every row. One commit of
+   // every fifty merges the tip of the next branch. The id of a commit is its position from the oldest one, that is
+   // the order of the dates.
+   QVector<qint32> tips(BRANCHES, 0);
+
+   mParents.resize(mCommits);
+   mShas.resize(mCommits);
+   mParentShas.resize(mCommits);
+
+   for (auto i = 0; i < mCommits; ++i)
+   {
+      mShas[i] = shaOf(i);
+
+      if (i == 0)
+         continue;
+
+      const auto branch = (i - 1) % BRANCHES;
+
+      mParents[i].append(tips.at(branch));
+
+      if (i % MERGE_INTERVAL == 0)
+         mParents[i].append(tips.at((branch + 1) % BRANCHES));
+
+      for (auto parent : qAsConst(mParents[i]))
+         mParentShas[i].append(shaOf(parent));
+
+      tips[branch] = i;
+   }
+}
+
+void LanesBenchmark::legacyLanes()
+{
+   qint64 sum = 0;
+
+   QBENCHMARK_ONCE
+   {
+      LegacyLanes lanes;
+      lanes.init(mShas.constLast());
+
+      // The graph goes from the newest commit to the oldest.
+      for (auto i = mCommits - 1; i >= 0; --i)
+         sum += checksum(calculateLegacyLanes(lanes, mShas.at(i), mParentShas.at(i)));
+   }
+
+   mLegacyChecksum = sum;
+}
+
+void LanesBenchmark::indexLanes()
+{
+   qint64 sum = 0;
+
+   QBENCHMARK_ONCE
+   {
+      Lanes lanes;
+      lanes.init(mCommits - 1);
+
+      // The same step GitCache::calculateLanes does for every commit.
+      for (auto i = mCommits - 1; i >= 0; --i)
+         sum += checksum(lanes.calculate(i, mParents.at(i)));
+   }
+
+   // Both engines must draw the same graph.
+   if (mLegacyChecksum != -1)
+      QCOMPARE(sum, mLegacyChecksum);
+}
+
+QTEST_APPLESS_MAIN(LanesBenchmark)
+
+#include "LanesBenchmark.moc"
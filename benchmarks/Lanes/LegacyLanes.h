@@ -0,0 +1,53 @@
+/*
+        Author: Marco Costalba (C) 2005-2007
+
+        Copyright: See COPYING file that comes with this distribution
+
+*/
+#ifndef LEGACY_LANES_H
+#define LEGACY_LANES_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <LaneType.h>
+#include <Lane.h>
+
+// The lanes engine as it was before the lanes were matched by commit index: the next commit of every lane is a SHA
+// string. It's kept as the baseline of the lanes benchmark.
+class LegacyLanes
+{
+public:
+   LegacyLanes() { } // init() will setup us later, when data is available
+   bool isEmpty() { return typeVec.empty(); }
+   void init(const QString &expectedSha);
+   void clear();
+   bool isFork(const QString &sha, bool &isDiscontinuity);
+   void setFork(const QString &sha);
+   void setMerge(const QStringList &parents);
+   void setInitial();
+   void changeActiveLane(const QString &sha);
+   void afterMerge();
+   void afterFork();
+   bool isBranch();
+   void afterBranch();
+   void nextParent(const QString &sha);
+   void setLanes(QVector<Lane> &ln) { ln = typeVec; } // O(1) vector is implicitly shared
+   QVector<Lane> getLanes() const { return typeVec; }
+
+private:
+   int findNextSha(const QString &next, int pos);
+   int findType(LaneType type, int pos);
+   int add(LaneType type, const QString &next, int pos);
+   bool isNode(Lane lane) const;
+
+   int activeLane;
+   QVector<Lane> typeVec; // Describes which glyphs should be drawn.
+   QVector<QString> nextShaVec; // The sha1 hashes of the next commit to appear in each lane (column).
+   LaneType NODE = LaneType::MERGE_FORK;
+   LaneType NODE_R = LaneType::MERGE_FORK_R;
+   LaneType NODE_L = LaneType::MERGE_FORK_L;
+};
+
+#endif
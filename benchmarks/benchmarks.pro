@@ -0,0 +1,12 @@
+# Benchmarks of the code that loads and lays out the history. They are not part of the application build:
+#
+#    qmake benchmarks.pro && make
+#    ./GitLogParser/GitLogParserBenchmark
+#    ./Lanes/LanesBenchmark
+#
+# The size of the synthetic inputs can be changed with the GQ_BENCHMARK_COMMITS environment variable.
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    GitLogParser \
+    Lanes
@@ -7,6 +7,8 @@
 #include <CommitDiffWidget.h>
 #include <GitQlientSettings.h>
 #include <GitHistory.h>
+#include <GitBase.h>
+#include <CommitInfo.h>
 
 #include <QPinnableTabWidget.h>
 #include <QLogger.h>
@@ -53,6 +55,12 @@ DiffWidget::DiffWidget(const QSharedPointer<GitBase> git, QSharedPointer<GitCach
    connect(mCommitDiffWidget, &CommitDiffWidget::signalShowFileHistory, this, &DiffWidget::signalShowFileHistory);
 
    mCommitDiffWidget->setVisible(false);
+
+   // The panels are configured again once the bodies are read if they were not loaded with the commits.
+   connect(mGit.data(), &GitBase::signalCommitBodyLoaded, this, [this](const QString &sha) {
+      if (sha == mInfoSha || sha == mInfoParentSha)
+         configureInfoPanels(mInfoSha, mInfoParentSha);
+   });
 }
 
 DiffWidget::~DiffWidget()
@@ -92,8 +100,7 @@ bool DiffWidget::loadFileDiff(const QString &currentSha, const QString &previous
 
       if (fileWithModifications)
       {
-         mInfoPanelBase->configure(mCache->getCommitInfo(currentSha));
-         mInfoPanelParent->configure(mCache->getCommitInfo(previousSha));
+         configureInfoPanels(currentSha, previousSha);
 
          mDiffWidgets.insert(id, fileDiffWidget);
 
@@ -139,8 +146,7 @@ bool DiffWidget::loadCommitDiff(const QString &sha, const QString &parentSha)
          const auto fullDiffWidget = new FullDiffWidget(mGit, mCache);
          fullDiffWidget->loadDiff(sha, parentSha, ret.output.toString());
 
-         mInfoPanelBase->configure(mCache->getCommitInfo(sha));
-         mInfoPanelParent->configure(mCache->getCommitInfo(parentSha));
+         configureInfoPanels(sha, parentSha);
 
          mDiffWidgets.insert(id, fullDiffWidget);
 
@@ -176,8 +182,7 @@ void DiffWidget::changeSelection(int index)
 
    if (widget)
    {
-      mInfoPanelBase->configure(mCache->getCommitInfo(widget->getCurrentSha()));
-      mInfoPanelParent->configure(mCache->getCommitInfo(widget->getPreviousSha()));
+      configureInfoPanels(widget->getCurrentSha(), widget->getPreviousSha());
    }
    else
       emit signalDiffEmpty();
@@ -193,3 +198,18 @@ void DiffWidget::onTabClosed(int index)
       mDiffWidgets.remove(key);
    }
 }
+
+void DiffWidget::configureInfoPanels(const QString &sha, const QString &parentSha)
+{
+   auto commit = mCache->getCommitInfo(sha);
+   auto parent = mCache->getCommitInfo(parentSha);
+
+   mInfoSha = sha;
+   mInfoParentSha = parentSha;
+
+   mGit->loadCommitBody(commit);
+   mGit->loadCommitBody(parent);
+
+   mInfoPanelBase->configure(commit);
+   mInfoPanelParent->configure(parent);
+}
@@ -113,6 +113,8 @@ private:
    QSharedPointer<GitCache> mCache;
    CommitInfoPanel *mInfoPanelBase = nullptr;
    CommitInfoPanel *mInfoPanelParent = nullptr;
+   QString mInfoSha;
+   QString mInfoParentSha;
    QPinnableTabWidget *mCenterStackedWidget = nullptr;
    QMap<QString, IDiffWidget *> mDiffWidgets;
    CommitDiffWidget *mCommitDiffWidget = nullptr;
@@ -130,4 +132,13 @@ private:
     * @param index The index to be closed.
     */
    void onTabClosed(int index);
+
+   /*!
+    \brief Shows the information of both commits in the info panels, reading their descriptions if they weren't loaded
+    with the history.
+
+    \param sha The SHA of the base commit.
+    \param parentSha The SHA of the parent commit.
+   */
+   void configureInfoPanels(const QString &sha, const QString &parentSha);
 };
@@ -144,6 +144,15 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
 
    connect(mGitLoader.data(), &GitRepoLoader::signalLoadingStarted, this, &GitQlientRepo::createProgressDialog);
    connect(mGitLoader.data(), &GitRepoLoader::signalLoadingFinished, this, &GitQlientRepo::onRepoLoadFinished);
+   connect(mGitLoader.data(), &GitRepoLoader::signalRevisionsAppended, this, &GitQlientRepo::onRevisionsAppended);
+   connect(mGitLoader.data(), &GitRepoLoader::signalLocalBranchDistancesLoaded, mHistoryWidget,
+           &HistoryWidget::onLocalBranchDistancesLoaded);
+   connect(mGitLoader.data(), &GitRepoLoader::signalRevisionsPageLoaded, mHistoryWidget,
+           &HistoryWidget::onRevisionsAppended);
+   connect(mGitLoader.data(), &GitRepoLoader::signalMoreRevisionsAvailable, mHistoryWidget,
+           &HistoryWidget::onMoreRevisionsAvailable);
+   connect(mHistoryWidget, &HistoryWidget::signalFetchMoreRevisions, mGitLoader.data(),
+           &GitRepoLoader::fetchMoreRevisions);
 
    m_loaderThread = new QThread();
    mGitLoader->moveToThread(m_loaderThread);
@@ -308,11 +317,34 @@ void GitQlientRepo::onRepoLoadFinished()
    const auto totalCommits = mGitQlientCache->count();
 
    mHistoryWidget->loadBranches();
-   mHistoryWidget->onNewRevisions(totalCommits);
+
+   if (mRevisionsStreamed)
+      mHistoryWidget->onRevisionsAppended(totalCommits);
+   else
+      mHistoryWidget->onNewRevisions(totalCommits);
+
    mBlameWidget->onNewRevisions(totalCommits);
 
+   mRevisionsStreamed = false;
+
+   if (mWaitDlg)
+      mWaitDlg->close();
+}
+
+void GitQlientRepo::onRevisionsAppended(int totalCommits)
+{
    if (mWaitDlg)
       mWaitDlg->close();
+
+   if (!mRevisionsStreamed)
+   {
+      mRevisionsStreamed = true;
+
+      mHistoryWidget->setEnabled(true);
+      mHistoryWidget->onNewRevisions(totalCommits);
+   }
+   else
+      mHistoryWidget->onRevisionsAppended(totalCommits);
 }
 
 void GitQlientRepo::loadFileDiff(const QString &currentSha, const QString &previousSha, const QString &file,
@@ -155,6 +155,7 @@ private:
    QSharedPointer<GitServer::IRestApi> mApi;
 
    bool mIsInit = false;
+   bool mRevisionsStreamed = false;
    QThread *m_loaderThread;
 
    /*!
@@ -217,6 +218,13 @@ private:
 
    */
    void onRepoLoadFinished();
+   /*!
+    \brief Shows the revisions received while the repository is still loading. The first batch closes the progress
+    dialog so the top of the history can be used while the rest is loaded.
+
+    \param totalCommits The total of commits in the cache.
+   */
+   void onRevisionsAppended(int totalCommits);
    /*!
     \brief Loads the view to show the diff of a specific file.
 
@@ -4,6 +4,7 @@
 #include <GitQlientSettings.h>
 
 GitQlientStyles *GitQlientStyles::INSTANCE = nullptr;
+int GitQlientStyles::COLORS_VERSION = 0;
 
 GitQlientStyles *GitQlientStyles::getInstance()
 {
@@ -167,9 +167,21 @@ public:
     \return QColor The color
    */
    static QColor getRefsColor();
+   /*!
+    \brief Gets the version of the colors. It changes every time the color schema is changed, so the widgets that
+    cache anything painted with the colors know when they must paint it again.
+
+    \return int The version.
+   */
+   static int getColorsVersion() { return COLORS_VERSION; }
+   /*!
+    \brief Notifies that the color schema has changed.
+   */
+   static void notifyColorsChanged() { ++COLORS_VERSION; }
 
 private:
    static GitQlientStyles *INSTANCE;
+   static int COLORS_VERSION;
 
    /*!
     \brief Default constructor.
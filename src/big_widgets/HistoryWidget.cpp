@@ -2,6 +2,8 @@
 
 #include <CommitHistoryModel.h>
 #include <CommitHistoryView.h>
+#include <CommitHistoryColumns.h>
+#include <HistoryFilter.h>
 #include <RepositoryViewDelegate.h>
 #include <BranchesWidget.h>
 #include <WipWidget.h>
@@ -77,10 +79,11 @@ HistoryWidget::HistoryWidget(const QSharedPointer<GitCache> &cache, const QShare
 
    mSearchInput = new QLineEdit();
    mSearchInput->setObjectName("SearchInput");
-   mSearchInput->setPlaceholderText(tr("Press Enter to search by SHA or log message..."));
+   updateSearchHints();
    connect(mSearchInput, &QLineEdit::returnPressed, this, &HistoryWidget::search);
 
    mRepositoryModel = new CommitHistoryModel(mCache, git, mGitServerCache);
+   connect(mRepositoryModel, &CommitHistoryModel::signalFetchMore, this, &HistoryWidget::signalFetchMoreRevisions);
    mRepositoryView = new CommitHistoryView(mCache, git, mGitServerCache);
 
    connect(mRepositoryView, &CommitHistoryView::signalViewUpdated, this, &HistoryWidget::signalViewUpdated);
@@ -97,6 +100,10 @@ HistoryWidget::HistoryWidget(const QSharedPointer<GitCache> &cache, const QShare
       commitSelected(rowIndex);
    });
    connect(mRepositoryView, &CommitHistoryView::signalAmendCommit, this, &HistoryWidget::onAmendCommit);
+   connect(mRepositoryView, &CommitHistoryView::signalFilterFinished, this, [this](int matches) {
+      if (matches == 0)
+         QMessageBox::information(this, tr("Not found!"), tr("No commits match the filter."));
+   });
    connect(mRepositoryView, &CommitHistoryView::signalMergeRequired, this, &HistoryWidget::mergeBranch);
    connect(mRepositoryView, &CommitHistoryView::signalCherryPickConflict, this,
            &HistoryWidget::signalCherryPickConflict);
@@ -201,6 +208,7 @@ HistoryWidget::~HistoryWidget()
 
 void HistoryWidget::clear()
 {
+   mRepositoryView->clearFilter();
    mRepositoryView->clear();
    resetWip();
    mBranchesWidget->clear();
@@ -251,13 +259,34 @@ void HistoryWidget::onNewRevisions(int totalCommits)
 {
    mRepositoryModel->onNewRevisions(totalCommits);
 
+   updateSearchHints();
+
    onCommitSelected(CommitInfo::ZERO_SHA);
 
+   // The WIP is never part of the filtered history.
+   if (mRepositoryView->hasActiveFilter())
+      return;
+
    mRepositoryView->selectionModel()->select(
        QItemSelection(mRepositoryModel->index(0, 0), mRepositoryModel->index(0, mRepositoryModel->columnCount() - 1)),
        QItemSelectionModel::Select);
 }
 
+void HistoryWidget::onRevisionsAppended(int totalCommits)
+{
+   mRepositoryModel->onRevisionsAppended(totalCommits);
+}
+
+void HistoryWidget::onLocalBranchDistancesLoaded(const QString &branch)
+{
+   mBranchesWidget->updateLocalBranchDistances(branch);
+}
+
+void HistoryWidget::onMoreRevisionsAvailable(bool available)
+{
+   mRepositoryModel->setCanFetchMore(available);
+}
+
 void HistoryWidget::keyPressEvent(QKeyEvent *event)
 {
    if (event->key() == Qt::Key_Shift)
@@ -289,10 +318,36 @@ void HistoryWidget::showFullDiff()
       QMessageBox::warning(this, tr("No diff available!"), tr("There is no diff to show."));
 }
 
+void HistoryWidget::updateSearchHints()
+{
+   auto toolTip = tr("Filter the history with author:<name> since:<yyyy-mm-dd> until:<yyyy-mm-dd> "
+                     "message:<regex> signed:<yes|no> ref:<branch or tag>");
+
+   // The bodies read on demand are not part of the search index nor the filters.
+   if (mCache->hasCommitBodies())
+      mSearchInput->setPlaceholderText(tr("Press Enter to search by SHA or log message..."));
+   else
+   {
+      mSearchInput->setPlaceholderText(tr("Press Enter to search by SHA or commit title..."));
+      toolTip.append(tr("\nThe commit bodies are not loaded (LazyCommitBodies), so only the titles are searched."));
+   }
+
+   mSearchInput->setToolTip(toolTip);
+}
+
 void HistoryWidget::search()
 {
    const auto text = mSearchInput->text();
 
+   if (const auto filter = HistoryFilter::fromQuery(text); !filter.isEmpty())
+   {
+      mRepositoryView->filterByCriteria(filter);
+      return;
+   }
+
+   if (mRepositoryView->hasCriteriaFilter())
+      mRepositoryView->clearFilter();
+
    if (!text.isEmpty())
    {
       auto commitInfo = mCache->getCommitInfo(text);
@@ -311,10 +366,27 @@ void HistoryWidget::search()
             startingRow = selectedItems.constFirst().row();
          }
 
-         commitInfo = mCache->getCommitInfoByField(CommitInfo::Field::SHORT_LOG, text, startingRow + 1, mReverseSearch);
+         // All the matches are found at once, the next one is the first after the selected row in the search
+         // direction. When there is none the search starts again from the other end.
+         const auto rows = mCache->searchRows(text);
+         auto row = -1;
+
+         if (!rows.isEmpty())
+         {
+            if (!mReverseSearch)
+            {
+               const auto next = std::upper_bound(rows.cbegin(), rows.cend(), startingRow);
+               row = next != rows.cend() ? *next : rows.constFirst();
+            }
+            else
+            {
+               const auto previous = std::lower_bound(rows.cbegin(), rows.cend(), startingRow);
+               row = previous != rows.cbegin() ? *(previous - 1) : rows.constLast();
+            }
+         }
 
-         if (commitInfo.isValid())
-            goToSha(commitInfo.sha());
+         if (row != -1)
+            goToSha(mCache->getCommitRow(row).sha());
          else
             QMessageBox::information(this, tr("Not found!"), tr("No commits where found based on the search text."));
       }
@@ -330,7 +402,8 @@ void HistoryWidget::goToSha(const QString &sha)
 
 void HistoryWidget::commitSelected(const QModelIndex &index)
 {
-   const auto sha = mRepositoryModel->sha(index.row());
+   // The index can belong to the filter of the view, so the SHA is read from the model of the index.
+   const auto sha = index.sibling(index.row(), static_cast<int>(CommitHistoryColumns::Sha)).data().toString();
 
    onCommitSelected(sha);
 }
@@ -147,6 +147,10 @@ signals:
     \brief Signal triggered  when the WIP needs to be updated.
    */
    void signalUpdateWip();
+   /*!
+    \brief Signal triggered when the graph needs the next page of revisions.
+   */
+   void signalFetchMoreRevisions();
    /**
     * @brief showPrDetailedView Signal that makes the view change to the Pull Request detailed view
     * @param pr The pull request number to show.
@@ -220,6 +224,24 @@ public:
     \param totalCommits The new total of commits to show in the graph.
    */
    void onNewRevisions(int totalCommits);
+   /*!
+    \brief Adds to the graph the revisions that were loaded since the last update without resetting the view.
+
+    \param totalCommits The new total of commits to show in the graph.
+   */
+   void onRevisionsAppended(int totalCommits);
+   /*!
+    \brief Shows the distances of a local branch once they have been calculated.
+
+    \param branch The full name of the local branch.
+   */
+   void onLocalBranchDistancesLoaded(const QString &branch);
+   /*!
+    \brief Sets if there are more revisions to load in the graph when it's loaded in pages.
+
+    \param available True if there are more revisions, otherwise false.
+   */
+   void onMoreRevisionsAvailable(bool available);
 
 protected:
    void keyPressEvent(QKeyEvent *event) override;
@@ -253,6 +275,11 @@ private:
    QPushButton *mReturnFromFull = nullptr;
    bool mReverseSearch = false;
 
+   /*!
+    \brief Updates the hints of the search QLineEdit depending on whether the commit bodies can be searched.
+
+   */
+   void updateSearchHints();
    /*!
     \brief Performs a search based on the input of the search QLineEdit with the users input.
 
@@ -23,6 +23,7 @@
 #include <QMenu>
 #include <QHeaderView>
 #include <QPushButton>
+#include <QTreeWidgetItemIterator>
 
 #include <QLogger.h>
 
@@ -460,19 +461,40 @@ void BranchesWidget::processLocalBranch(const QString &sha, QString branch)
       }
    }
 
-   QLog_Debug("UI", QString("Calculating distances..."));
-
    if (fullBranchName != "detached")
+      setLocalBranchDistances(item, fullBranchName);
+
+   mLocalBranchesTree->addTopLevelItem(item);
+
+   QLog_Debug("UI", QString("Finish gathering local branch information"));
+}
+
+void BranchesWidget::updateLocalBranchDistances(const QString &branch)
+{
+   for (QTreeWidgetItemIterator it(mLocalBranchesTree); *it; ++it)
    {
-      const auto distances = mCache->getLocalBranchDistances(fullBranchName);
+      if ((*it)->data(0, GitQlient::IsLeaf).toBool() && (*it)->data(0, GitQlient::FullNameRole).toString() == branch)
+      {
+         setLocalBranchDistances(*it, branch);
+         break;
+      }
+   }
+}
 
-      item->setText(1, QString("%1 \u2193 - %2 \u2191").arg(distances.behindMaster).arg(distances.aheadMaster));
-      item->setText(2, QString("%1 \u2193 - %2 \u2191").arg(distances.behindOrigin).arg(distances.aheadOrigin));
+void BranchesWidget::setLocalBranchDistances(QTreeWidgetItem *item, const QString &branch)
+{
+   // The distances are calculated after the graph is loaded. Until then the columns show a placeholder.
+   if (!mCache->hasLocalBranchDistances(branch))
+   {
+      item->setText(1, QString("\u2026"));
+      item->setText(2, QString("\u2026"));
+      return;
    }
 
-   mLocalBranchesTree->addTopLevelItem(item);
+   const auto distances = mCache->getLocalBranchDistances(branch);
 
-   QLog_Debug("UI", QString("Finish gathering local branch information"));
+   item->setText(1, QString("%1 \u2193 - %2 \u2191").arg(distances.behindMaster).arg(distances.aheadMaster));
+   item->setText(2, QString("%1 \u2193 - %2 \u2191").arg(distances.behindOrigin).arg(distances.aheadOrigin));
 }
 
 void BranchesWidget::processRemoteBranch(const QString &sha, QString branch)
@@ -32,6 +32,7 @@ class QLabel;
 class GitBase;
 class GitCache;
 class QPushButton;
+class QTreeWidgetItem;
 class BranchesWidgetMinimal;
 
 /*!
@@ -121,6 +122,13 @@ public:
     */
    void forceMinimalView();
 
+   /**
+    * @brief updateLocalBranchDistances Updates the distances to master and to the remote shown for a local branch once
+    * they have been calculated.
+    * @param branch The full name of the local branch.
+    */
+   void updateLocalBranchDistances(const QString &branch);
+
 private:
    QSharedPointer<GitCache> mCache;
    QSharedPointer<GitBase> mGit;
@@ -153,6 +161,14 @@ private:
     \param branch The remote branch to be added in the tree widget.
    */
    void processRemoteBranch(const QString &sha, QString branch);
+   /*!
+    \brief Shows the distances of a local branch in the columns of its item or a placeholder if they are not
+    calculated yet.
+
+    \param item The item of the branch.
+    \param branch The full name of the branch.
+   */
+   void setLocalBranchDistances(QTreeWidgetItem *item, const QString &branch);
    /*!
     \brief Process all the tags and adds them into the QListWidget.
 
@@ -1,20 +1,37 @@
 INCLUDEPATH += $$PWD
 
 HEADERS += \
+    $$PWD/CommitDisplayData.h \
+    $$PWD/CommitGraphCache.h \
     $$PWD/CommitInfo.h \
+    $$PWD/CommitOid.h \
+    $$PWD/CommitRow.h \
+    $$PWD/CommitSearchIndex.h \
+    $$PWD/CommitStore.h \
     $$PWD/GitCache.h \
     $$PWD/GitServerCache.h \
+    $$PWD/GraphRows.h \
+    $$PWD/HistoryFilter.h \
     $$PWD/Lane.h \
     $$PWD/LaneType.h \
+    $$PWD/PathTable.h \
     $$PWD/References.h \
     $$PWD/RevisionFiles.h \
     $$PWD/lanes.h
 
 SOURCES += \
+    $$PWD/CommitDisplayData.cpp \
+    $$PWD/CommitGraphCache.cpp \
     $$PWD/CommitInfo.cpp \
+    $$PWD/CommitOid.cpp \
+    $$PWD/CommitRow.cpp \
+    $$PWD/CommitSearchIndex.cpp \
+    $$PWD/CommitStore.cpp \
     $$PWD/GitCache.cpp \
     $$PWD/GitServerCache.cpp \
+    $$PWD/HistoryFilter.cpp \
     $$PWD/Lane.cpp \
+    $$PWD/PathTable.cpp \
     $$PWD/References.cpp \
     $$PWD/RevisionFiles.cpp \
     $$PWD/lanes.cpp
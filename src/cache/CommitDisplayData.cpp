@@ -0,0 +1,131 @@
+#include "CommitDisplayData.h"
+
+#include <CommitStore.h>
+#include <GraphRows.h>
+
+#include <QDateTime>
+
+namespace
+{
+const int MINUTES_PER_DAY = 24 * 60;
+}
+
+CommitDisplayData::CommitDisplayData(quint32 generation)
+   : mGeneration(generation)
+{
+}
+
+void CommitDisplayData::update(const CommitStore &store, const GraphRows &rows, qint64 wipDate)
+{
+   if (mTimes.isEmpty())
+   {
+      mTimes.reserve(MINUTES_PER_DAY);
+
+      for (auto minute = 0; minute < MINUTES_PER_DAY; ++minute)
+         mTimes.append(QTime(minute / 60, minute % 60).toString("hh:mm"));
+   }
+
+   QVector<qint32> pending;
+   QVector<qint32> added;
+
+   // The placeholders that were filled since the last update are added out of order.
+   for (auto idx : qAsConst(mPending))
+   {
+      if (store.isLoaded(idx))
+      {
+         addCommit(store, idx);
+         added.append(idx);
+      }
+      else
+         pending.append(idx);
+   }
+
+   mDays.reserve(store.count());
+   mMinutes.reserve(store.count());
+   mAuthorIds.reserve(store.count());
+
+   for (auto idx = mDays.count(); idx < store.count(); ++idx)
+   {
+      mDays.append(NO_DAY);
+      mMinutes.append(0);
+      mAuthorIds.append(-1);
+
+      if (store.isLoaded(idx))
+      {
+         addCommit(store, idx);
+         added.append(idx);
+      }
+      else
+         pending.append(idx);
+   }
+
+   mPending = pending;
+   mSameDay.resize(mDays.count());
+
+   // The rows of the commits already there don't move relative to each other, so only the flags of the new rows and
+   // the rows below them change. The first row also depends on the date of the WIP.
+   updateSameDay(rows, 1, wipDate);
+
+   for (auto idx : qAsConst(added))
+   {
+      if (const auto row = store.row(idx); row > 0)
+      {
+         updateSameDay(rows, row, wipDate);
+         updateSameDay(rows, row + 1, wipDate);
+      }
+   }
+}
+
+QString CommitDisplayData::date(int idx) const
+{
+   return mDayTexts.value(mDays.at(idx)) + QChar(' ') + time(idx);
+}
+
+QString CommitDisplayData::longDate(int idx) const
+{
+   return mDayTexts.value(mDays.at(idx)) + QStringLiteral(" - ") + time(idx);
+}
+
+QString CommitDisplayData::shortAuthor(const QString &author)
+{
+   return author.split("<").first();
+}
+
+void CommitDisplayData::addCommit(const CommitStore &store, int idx)
+{
+   const auto dateTime = QDateTime::fromSecsSinceEpoch(store.date(idx));
+   const auto date = dateTime.date();
+   const auto time = dateTime.time();
+   const auto day = date.toJulianDay();
+
+   if (!mDayTexts.contains(day))
+      mDayTexts.insert(day, date.toString("dd MMM yyyy"));
+
+   const auto author = store.author(idx);
+   auto authorId = mAuthorIdsByName.value(author, -1);
+
+   if (authorId == -1)
+   {
+      authorId = mAuthors.count();
+      mAuthors.append(shortAuthor(author));
+      mAuthorIdsByName.insert(author, authorId);
+   }
+
+   mDays[idx] = day;
+   mMinutes[idx] = static_cast<qint16>(time.hour() * 60 + time.minute());
+   mAuthorIds[idx] = authorId;
+}
+
+void CommitDisplayData::updateSameDay(const GraphRows &rows, int row, qint64 wipDate)
+{
+   if (row < 1 || row >= rows.count())
+      return;
+
+   const auto previousIdx = rows.at(row - 1);
+   const auto previousDay = row == 1 ? QDateTime::fromSecsSinceEpoch(wipDate).date().toJulianDay()
+                                     : contains(previousIdx) ? mDays.at(previousIdx) : NO_DAY;
+   const auto idx = rows.at(row);
+   const auto day = contains(idx) ? mDays.at(idx) : NO_DAY;
+
+   mSameDay.setBit(idx, day != NO_DAY && day == previousDay);
+}
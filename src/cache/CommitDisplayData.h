@@ -0,0 +1,121 @@
+#pragma once
+
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QBitArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include <limits>
+
+class CommitStore;
+class GraphRows;
+
+/**
+ * @brief The CommitDisplayData class keeps the texts the history view shows for the commits of a @ref CommitStore,
+ * so they are not formatted every time a cell is painted. The texts repeat a lot (the authors, the days and the
+ * minutes of the day), so every commit only has the ids of the texts and the texts are stored once.
+ *
+ * It also has a flag per commit that tells if it's from the same day as the commit in the previous row of the graph.
+ * The flag is kept by commit and not by row, so when rows are prepended only the first of the old rows is outdated
+ * until the next update.
+ *
+ * @class CommitDisplayData CommitDisplayData.h "CommitDisplayData.h"
+ */
+class CommitDisplayData
+{
+public:
+   /**
+    * @brief Creates empty display data.
+    *
+    * @param generation Identifies the store the data is built from.
+    */
+   explicit CommitDisplayData(quint32 generation = 0);
+
+   quint32 generation() const { return mGeneration; }
+
+   /**
+    * @brief Adds the commits of the store that don't have display data yet and updates the flags of their rows and of
+    * the rows below them.
+    *
+    * @param store The store the data is built from.
+    * @param rows The rows of the graph.
+    * @param wipDate The author date of the WIP, in seconds since epoch.
+    */
+   void update(const CommitStore &store, const GraphRows &rows, qint64 wipDate);
+
+   /**
+    * @brief Whether the commit of the store has display data.
+    */
+   bool contains(int idx) const { return idx >= 0 && idx < mDays.count() && mDays.at(idx) != NO_DAY; }
+
+   /**
+    * @brief The name of the author without the email.
+    */
+   QString author(int idx) const { return mAuthors.at(mAuthorIds.at(idx)); }
+   /**
+    * @brief The date with the format "dd MMM yyyy hh:mm".
+    */
+   QString date(int idx) const;
+   /**
+    * @brief The date with the format "dd MMM yyyy - hh:mm".
+    */
+   QString longDate(int idx) const;
+   /**
+    * @brief The time with the format "hh:mm".
+    */
+   QString time(int idx) const { return mTimes.at(mMinutes.at(idx)); }
+   /**
+    * @brief The day of the date, as a Julian day.
+    */
+   qint64 day(int idx) const { return mDays.at(idx); }
+   /**
+    * @brief Whether the commit is from the same day as the commit in the previous row.
+    */
+   bool isSameDayAsPrevious(int idx) const { return idx < mSameDay.size() && mSameDay.testBit(idx); }
+
+   /**
+    * @brief Formats the short name of an author.
+    */
+   static QString shortAuthor(const QString &author);
+
+private:
+   static constexpr qint64 NO_DAY = std::numeric_limits<qint64>::min();
+
+   quint32 mGeneration = 0;
+   QVector<qint32> mPending;
+   QVector<qint64> mDays;
+   QVector<qint16> mMinutes;
+   QVector<qint32> mAuthorIds;
+   QVector<QString> mAuthors;
+   QHash<QString, qint32> mAuthorIdsByName;
+   QHash<qint64, QString> mDayTexts;
+   QVector<QString> mTimes;
+   QBitArray mSameDay;
+
+   void addCommit(const CommitStore &store, int idx);
+   void updateSameDay(const GraphRows &rows, int row, qint64 wipDate);
+};
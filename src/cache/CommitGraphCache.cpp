@@ -0,0 +1,172 @@
+#include "CommitGraphCache.h"
+
+#include <QDataStream>
+#include <QSaveFile>
+
+#include <QLogger.h>
+
+#include <limits>
+
+using namespace QLogger;
+
+namespace
+{
+const QString CACHE_FILE_NAME = QStringLiteral("/GitQlientCommits.cache");
+const quint32 MAGIC = 0x47514347; // GQCG
+const quint32 VERSION = 3;
+const auto STREAM_VERSION = QDataStream::Qt_5_9;
+}
+
+CommitGraphCache::CommitGraphCache(const QString &gitDir)
+   : mFile(gitDir + CACHE_FILE_NAME)
+{
+}
+
+CommitGraphCache::~CommitGraphCache()
+{
+   close();
+}
+
+bool CommitGraphCache::open()
+{
+   if (!mFile.exists() || !mFile.open(QIODevice::ReadOnly))
+      return false;
+
+   mSize = mFile.size();
+
+   // QDataStream works with int sizes when it reads from a QByteArray.
+   if (mSize <= 0 || mSize > std::numeric_limits<int>::max() || !(mData = mFile.map(0, mSize)))
+   {
+      QLog_Warning("Git", "The commits cache file can't be mapped.");
+      return false;
+   }
+
+   const auto bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(mData), static_cast<int>(mSize));
+   QDataStream in(bytes);
+   in.setVersion(STREAM_VERSION);
+
+   quint32 magic = 0;
+   quint32 version = 0;
+
+   in >> magic >> version;
+
+   if (magic != MAGIC || version != VERSION)
+   {
+      QLog_Info("Git", "The commits cache file has an old format and will be discarded.");
+      return false;
+   }
+
+   in >> mKey.head >> mKey.tips >> mKey.withBodies;
+
+   if (in.status() != QDataStream::Ok)
+      return false;
+
+   mCommitsOffset = in.device()->pos();
+
+   return true;
+}
+
+bool CommitGraphCache::read(CommitStore &store, GraphRows &rows) const
+{
+   if (!mData)
+      return false;
+
+   const auto bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(mData), static_cast<int>(mSize));
+   QDataStream in(bytes);
+   in.setVersion(STREAM_VERSION);
+   in.device()->seek(mCommitsOffset);
+
+   auto success = store.read(in);
+   qint32 count = 0;
+
+   if (success)
+   {
+      in >> count;
+      success = in.status() == QDataStream::Ok && count >= 0
+          && count <= in.device()->bytesAvailable() / static_cast<int>(sizeof(qint32));
+   }
+
+   QVector<qint32> graphRows(success ? count : 0);
+   const auto rowsBytes = graphRows.count() * static_cast<int>(sizeof(qint32));
+
+   success = success && in.readRawData(reinterpret_cast<char *>(graphRows.data()), rowsBytes) == rowsBytes;
+
+   rows.clear();
+   rows.reserve(graphRows.count() + 1);
+   rows.append(-1);
+
+   // The store keeps the row of every commit too, so both must agree.
+   for (auto i = 0; success && i < graphRows.count(); ++i)
+   {
+      const auto idx = graphRows.at(i);
+
+      success = idx >= 0 && idx < store.count() && store.isLoaded(idx) && store.row(idx) == rows.count();
+
+      rows.append(idx);
+   }
+
+   if (!success)
+   {
+      QLog_Warning("Git", "The commits cache file is corrupted.");
+      store.clear();
+      rows.clear();
+   }
+
+   return success;
+}
+
+bool CommitGraphCache::write(const Key &key, const CommitStore &store, const GraphRows &rows) const
+{
+   QSaveFile file(mFile.fileName());
+
+   if (!file.open(QIODevice::WriteOnly))
+   {
+      QLog_Warning("Git", QString("The commits cache file {%1} can't be written.").arg(file.fileName()));
+      return false;
+   }
+
+   QDataStream out(&file);
+   out.setVersion(STREAM_VERSION);
+
+   out << MAGIC << VERSION << key.head << key.tips << key.withBodies;
+
+   store.write(out);
+
+   // The first row is the WIP, that is not in the store.
+   const auto count = qMax(rows.count() - 1, 0);
+
+   out << static_cast<qint32>(count);
+
+   for (auto row = 1; row < rows.count(); ++row)
+   {
+      const auto idx = rows.at(row);
+      out.writeRawData(reinterpret_cast<const char *>(&idx), static_cast<int>(sizeof(idx)));
+   }
+
+   if (out.status() != QDataStream::Ok || !file.commit())
+   {
+      QLog_Warning("Git", QString("The commits cache file {%1} can't be written.").arg(file.fileName()));
+      return false;
+   }
+
+   QLog_Debug("Git", QString("The commits cache has been written with {%1} commits.").arg(count));
+
+   return true;
+}
+
+void CommitGraphCache::close()
+{
+   if (mData)
+   {
+      mFile.unmap(mData);
+      mData = nullptr;
+   }
+
+   mFile.close();
+}
+
+void CommitGraphCache::remove()
+{
+   close();
+   mFile.remove();
+}
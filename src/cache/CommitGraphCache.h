@@ -0,0 +1,117 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitStore.h>
+#include <GraphRows.h>
+
+#include <QFile>
+#include <QStringList>
+
+/**
+ * @brief The CommitGraphCache class stores the parsed history of a repository in a binary file inside the Git
+ * directory. The file is memory mapped when it's read, so opening it and checking if it's still valid doesn't require
+ * reading the commits.
+ *
+ * The file holds the arrays of the @ref CommitStore as they are in memory, with the lanes that were calculated for
+ * every commit, and the rows of the graph. They are read back into the store without building the commits again. It's
+ * keyed by the HEAD and the tips of the references it was built from.
+ *
+ * @class CommitGraphCache CommitGraphCache.h "CommitGraphCache.h"
+ */
+class CommitGraphCache
+{
+public:
+   /**
+    * @brief The state of the references when the cache was built.
+    */
+   struct Key
+   {
+      QString head;
+      QStringList tips;
+      bool withBodies = true;
+
+      bool isValid() const { return !head.isEmpty() && !tips.isEmpty(); }
+      bool operator==(const Key &key) const
+      {
+         return head == key.head && tips == key.tips && withBodies == key.withBodies;
+      }
+      bool operator!=(const Key &key) const { return !(*this == key); }
+   };
+
+   /**
+    * @brief Creates the cache for the repository that has its Git data in @p gitDir.
+    *
+    * @param gitDir The Git directory of the repository.
+    */
+   explicit CommitGraphCache(const QString &gitDir);
+   ~CommitGraphCache();
+
+   /**
+    * @brief Maps the file and reads its key.
+    *
+    * @return True if the file exists and has a compatible format.
+    */
+   bool open();
+   /**
+    * @brief The references the cache was built from. Only valid after a successful call to @ref open.
+    */
+   Key key() const { return mKey; }
+   /**
+    * @brief Reads the commits from the mapped file.
+    *
+    * @param store The store where the commits and their lanes are read.
+    * @param rows The rows of the graph. The first row is the WIP, that is not in the file.
+    * @return True if the file was read. It's false if the file is corrupted.
+    */
+   bool read(CommitStore &store, GraphRows &rows) const;
+
+   /**
+    * @brief Writes the cache file. The file is replaced atomically so it's safe to call this while other instance
+    * has the previous file opened.
+    *
+    * @param key The references the commits come from.
+    * @param store The store with the commits and their lanes.
+    * @param rows The rows of the graph. The first row is the WIP and it's not written.
+    * @return True if the file was written.
+    */
+   bool write(const Key &key, const CommitStore &store, const GraphRows &rows) const;
+
+   /**
+    * @brief Unmaps and closes the file. The commits read are still valid, but the file can't be read again until
+    * it's opened. It must be closed before the cache is written, since a mapped file can't be replaced in Windows.
+    */
+   void close();
+   /**
+    * @brief Deletes the cache file.
+    */
+   void remove();
+
+private:
+   QFile mFile;
+   uchar *mData = nullptr;
+   qint64 mSize = 0;
+   qint64 mCommitsOffset = 0;
+   Key mKey;
+};
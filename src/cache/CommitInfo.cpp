@@ -9,24 +9,45 @@ CommitInfo::CommitInfo(const QString sha, const QStringList &parents, const QCha
                        const QDateTime &commitDate, const QString &author, const QString &log, const QString &longLog,
                        bool isSigned, const QString &gpgKey)
 {
-   mSha = sha;
-   mParentsSha = parents;
+   mOid = CommitOid::fromString(sha);
+
+   for (const auto &parent : parents)
+   {
+      if (const auto parentOid = CommitOid::fromString(parent); parentOid.isValid())
+         mParents.append(parentOid);
+   }
+
    mBoundaryInfo = boundary;
    mCommitter = commiter;
    mCommitDate = commitDate;
    mAuthor = author;
    mShortLog = log;
-   mLongLog = longLog;
+   mLongLog = longLog.toUtf8();
    mSigned = isSigned;
    mGpgKey = gpgKey;
 }
 
+CommitInfo::CommitInfo(const CommitOid &oid, const QVector<CommitOid> &parents, const QChar &boundary,
+                       const QString &commiter, const QDateTime &commitDate, const QString &author, const QString &log,
+                       const QByteArray &longLogUtf8, bool isSigned, const QString &gpgKey)
+   : mBoundaryInfo(boundary)
+   , mOid(oid)
+   , mParents(parents)
+   , mCommitter(commiter)
+   , mAuthor(author)
+   , mCommitDate(commitDate)
+   , mShortLog(log)
+   , mLongLog(longLogUtf8)
+   , mSigned(isSigned)
+   , mGpgKey(gpgKey)
+{
+}
+
 bool CommitInfo::operator==(const CommitInfo &commit) const
 {
-   return (mSha == commit.mSha || mSha.startsWith(commit.sha()) || commit.sha().startsWith(mSha))
-       && mParentsSha == commit.mParentsSha && mCommitter == commit.mCommitter && mAuthor == commit.mAuthor
-       && mCommitDate == commit.mCommitDate && mShortLog == commit.mShortLog && mLongLog == commit.mLongLog
-       && mLanes == commit.mLanes;
+   return mOid == commit.mOid && mParents == commit.mParents && mCommitter == commit.mCommitter
+       && mAuthor == commit.mAuthor && mCommitDate == commit.mCommitDate && mShortLog == commit.mShortLog
+       && mLongLog == commit.mLongLog && mLanes == commit.mLanes;
 }
 
 bool CommitInfo::operator!=(const CommitInfo &commit) const
@@ -59,9 +80,10 @@ QString CommitInfo::getFieldStr(CommitInfo::Field field) const
 
 int CommitInfo::parentsCount() const
 {
-   auto count = mParentsSha.count();
+   static const auto initOid = CommitOid::fromString(CommitInfo::INIT_SHA);
+   auto count = mParents.count();
 
-   if (count > 0 && mParentsSha.contains(CommitInfo::INIT_SHA))
+   if (count > 0 && mParents.contains(initOid))
       --count;
 
    return count;
@@ -69,19 +91,36 @@ int CommitInfo::parentsCount() const
 
 QString CommitInfo::parent(int idx) const
 {
-   return mParentsSha.count() > idx ? mParentsSha.at(idx) : QString();
+   return mParents.count() > idx ? mParents.at(idx).toString() : QString();
 }
 
 QStringList CommitInfo::parents() const
 {
-   return mParentsSha;
+   QStringList parents;
+   parents.reserve(mParents.count());
+
+   for (const auto &parent : mParents)
+      parents.append(parent.toString());
+
+   return parents;
 }
 
 bool CommitInfo::isValid() const
 {
-   static QRegExp hexMatcher("^[0-9A-F]{40}$", Qt::CaseInsensitive);
+   return mOid.isValid();
+}
+
+bool CommitInfo::isWip() const
+{
+   static const auto zeroOid = CommitOid::fromString(ZERO_SHA);
 
-   return !mSha.isEmpty() && hexMatcher.exactMatch(mSha);
+   return mOid == zeroOid;
+}
+
+void CommitInfo::setLongLog(const QString &longLog)
+{
+   mLongLog = longLog.toUtf8();
+   mLongLogLoaded = true;
 }
 
 int CommitInfo::getActiveLane() const
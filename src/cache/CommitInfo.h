@@ -29,6 +29,7 @@
 
 #include <Lane.h>
 #include <References.h>
+#include <CommitOid.h>
 
 class CommitInfo
 {
@@ -48,27 +49,36 @@ public:
    explicit CommitInfo(const QString sha, const QStringList &parents, const QChar &boundary, const QString &commiter,
                        const QDateTime &commitDate, const QString &author, const QString &log,
                        const QString &longLog = QString(), bool isSigned = false, const QString &gpgKey = QString());
+   explicit CommitInfo(const CommitOid &oid, const QVector<CommitOid> &parents, const QChar &boundary,
+                       const QString &commiter, const QDateTime &commitDate, const QString &author, const QString &log,
+                       const QByteArray &longLogUtf8, bool isSigned = false, const QString &gpgKey = QString());
    bool operator==(const CommitInfo &commit) const;
    bool operator!=(const CommitInfo &commit) const;
 
    QString getFieldStr(CommitInfo::Field field) const;
 
    void setBoundary(QChar info) { mBoundaryInfo = std::move(info); }
+   QChar boundary() const { return mBoundaryInfo; }
    bool isBoundary() const { return mBoundaryInfo == '-'; }
    int parentsCount() const;
    QString parent(int idx) const;
    QStringList parents() const;
+   QVector<CommitOid> parentOids() const { return mParents; }
 
-   QString sha() const { return mSha; }
+   QString sha() const { return mOid.isValid() ? mOid.toString() : QString(); }
+   CommitOid oid() const { return mOid; }
    QString committer() const { return mCommitter; }
    QString author() const { return mAuthor; }
    QString authorDate() const { return QString::number(mCommitDate.toSecsSinceEpoch()); }
    QString shortLog() const { return mShortLog; }
-   QString longLog() const { return mLongLog; }
-   QString fullLog() const { return QString("%1\n\n%2").arg(mShortLog, mLongLog.trimmed()); }
+   QString longLog() const { return QString::fromUtf8(mLongLog); }
+   bool isLongLogLoaded() const { return mLongLogLoaded; }
+   void setLongLogLoaded(bool loaded) { mLongLogLoaded = loaded; }
+   void setLongLog(const QString &longLog);
+   QString fullLog() const { return QString("%1\n\n%2").arg(mShortLog, longLog().trimmed()); }
 
    bool isValid() const;
-   bool isWip() const { return mSha == ZERO_SHA; }
+   bool isWip() const;
 
    void setLanes(const QVector<Lane> &lanes) { mLanes = lanes; }
    QVector<Lane> getLanes() const { return mLanes; }
@@ -81,9 +91,8 @@ public:
    QStringList getReferences(References::Type type) const { return mReferences.getReferences(type); }
    bool hasReferences() const { return !mReferences.isEmpty(); }
 
-   void addChildReference(CommitInfo *commit) { mChilds.insert(commit->sha(), commit); }
-   QList<CommitInfo *> getChilds() const { return mChilds.values(); }
-   bool hasChilds() const { return !mChilds.empty(); }
+   void setHasChilds(bool hasChilds) { mHasChilds = hasChilds; }
+   bool hasChilds() const { return mHasChilds; }
 
    void clearReferences() { mReferences.clear(); }
 
@@ -95,17 +104,18 @@ public:
 
 private:
    QChar mBoundaryInfo;
-   QString mSha;
-   QStringList mParentsSha;
+   CommitOid mOid;
+   QVector<CommitOid> mParents;
    QString mCommitter;
    QString mAuthor;
    QDateTime mCommitDate;
    QString mShortLog;
-   QString mLongLog;
+   QByteArray mLongLog;
+   bool mLongLogLoaded = true;
    QString mDiff;
    QVector<Lane> mLanes;
    References mReferences;
-   QMap<QString, CommitInfo *> mChilds;
+   bool mHasChilds = false;
    bool mSigned = false;
    QString mGpgKey;
 };
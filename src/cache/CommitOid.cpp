@@ -0,0 +1,123 @@
+#include "CommitOid.h"
+
+#include <cstring>
+
+namespace
+{
+int hexValue(int c)
+{
+   if (c >= '0' && c <= '9')
+      return c - '0';
+   if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+   if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+
+   return -1;
+}
+}
+
+CommitOid CommitOid::fromHex(const char *hex, int length)
+{
+   CommitOid oid;
+
+   if (length != HEX_LENGTH)
+      return oid;
+
+   for (auto i = 0; i < BYTES; ++i)
+   {
+      const auto high = hexValue(hex[2 * i]);
+      const auto low = hexValue(hex[2 * i + 1]);
+
+      if (high == -1 || low == -1)
+         return CommitOid();
+
+      oid.mBytes[i] = static_cast<uchar>((high << 4) | low);
+   }
+
+   oid.mValid = true;
+
+   return oid;
+}
+
+CommitOid CommitOid::fromString(const QString &sha)
+{
+   if (sha.length() != HEX_LENGTH)
+      return CommitOid();
+
+   char hex[HEX_LENGTH];
+
+   for (auto i = 0; i < HEX_LENGTH; ++i)
+      hex[i] = sha.at(i).toLatin1();
+
+   return fromHex(hex, HEX_LENGTH);
+}
+
+CommitOid CommitOid::fromBytes(const uchar *bytes)
+{
+   CommitOid oid;
+   std::memcpy(oid.mBytes.data(), bytes, BYTES);
+   oid.mValid = true;
+
+   return oid;
+}
+
+CommitOid CommitOid::fromPrefix(const QString &prefix)
+{
+   CommitOid oid;
+
+   if (prefix.isEmpty() || prefix.length() > HEX_LENGTH)
+      return oid;
+
+   for (auto i = 0; i < prefix.length(); ++i)
+   {
+      const auto value = hexValue(prefix.at(i).toLatin1());
+
+      if (value == -1)
+         return CommitOid();
+
+      oid.mBytes[i / 2] |= static_cast<uchar>(i % 2 == 0 ? value << 4 : value);
+   }
+
+   oid.mValid = true;
+
+   return oid;
+}
+
+bool CommitOid::startsWith(const CommitOid &prefix, int digits) const
+{
+   const auto bytes = digits / 2;
+
+   if (std::memcmp(mBytes.data(), prefix.mBytes.data(), static_cast<size_t>(bytes)) != 0)
+      return false;
+
+   return digits % 2 == 0 || (mBytes[bytes] & 0xf0) == (prefix.mBytes[bytes] & 0xf0);
+}
+
+QString CommitOid::toString() const
+{
+   static const char digits[] = "0123456789abcdef";
+
+   if (!mValid)
+      return QString();
+
+   QString sha(HEX_LENGTH, Qt::Uninitialized);
+   auto out = sha.data();
+
+   for (auto byte : mBytes)
+   {
+      *out++ = QLatin1Char(digits[byte >> 4]);
+      *out++ = QLatin1Char(digits[byte & 0xf]);
+   }
+
+   return sha;
+}
+
+uint qHash(const CommitOid &oid, uint seed)
+{
+   // SHA-1 is already uniformly distributed so the first bytes are enough.
+   uint hash = 0;
+   std::memcpy(&hash, oid.data(), sizeof(hash));
+
+   return hash ^ seed;
+}
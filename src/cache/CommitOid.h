@@ -0,0 +1,98 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QString>
+#include <QHash>
+
+#include <array>
+
+/**
+ * @brief The CommitOid class stores the binary representation of a Git object id (SHA-1). It uses 20 bytes instead of
+ * the 80 bytes plus the allocation of the hexadecimal QString and it's compared byte-wise.
+ *
+ * @class CommitOid CommitOid.h "CommitOid.h"
+ */
+class CommitOid
+{
+public:
+   static constexpr int BYTES = 20;
+   static constexpr int HEX_LENGTH = 2 * BYTES;
+
+   CommitOid() = default;
+
+   /**
+    * @brief Parses a hexadecimal SHA from raw bytes (for example, the output of Git).
+    *
+    * @param hex The hexadecimal characters.
+    * @param length The number of characters. It must be exactly @ref HEX_LENGTH.
+    * @return CommitOid The object id. It's not valid if the input isn't a full SHA.
+    */
+   static CommitOid fromHex(const char *hex, int length);
+   /**
+    * @brief Parses a hexadecimal SHA stored in a QString.
+    *
+    * @param sha The SHA.
+    * @return CommitOid The object id. It's not valid if the input isn't a full SHA.
+    */
+   static CommitOid fromString(const QString &sha);
+   /**
+    * @brief Builds the object id from its binary representation.
+    *
+    * @param bytes A buffer of at least @ref BYTES bytes.
+    * @return CommitOid The object id.
+    */
+   static CommitOid fromBytes(const uchar *bytes);
+   /**
+    * @brief Parses the beginning of a hexadecimal SHA. The bytes that are not in the prefix are zero, so the object id
+    * is the lowest one that starts with the prefix.
+    *
+    * @param prefix Between 1 and @ref HEX_LENGTH hexadecimal characters.
+    * @return CommitOid The object id. It's not valid if the input isn't a hexadecimal prefix.
+    */
+   static CommitOid fromPrefix(const QString &prefix);
+
+   /**
+    * @brief Checks if the object id starts with the first digits of another one.
+    *
+    * @param prefix The object id with the prefix, usually built with @ref fromPrefix.
+    * @param digits The number of hexadecimal digits to compare.
+    * @return True if the digits are the same.
+    */
+   bool startsWith(const CommitOid &prefix, int digits) const;
+
+   bool isValid() const { return mValid; }
+   QString toString() const;
+   const uchar *data() const { return mBytes.data(); }
+
+   bool operator==(const CommitOid &oid) const { return mValid == oid.mValid && mBytes == oid.mBytes; }
+   bool operator!=(const CommitOid &oid) const { return !(*this == oid); }
+   bool operator<(const CommitOid &oid) const { return mBytes < oid.mBytes; }
+
+private:
+   std::array<uchar, BYTES> mBytes {};
+   bool mValid = false;
+};
+
+uint qHash(const CommitOid &oid, uint seed = 0);
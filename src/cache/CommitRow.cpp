@@ -0,0 +1,121 @@
+#include "CommitRow.h"
+
+#include <CommitDisplayData.h>
+#include <CommitInfo.h>
+#include <CommitStore.h>
+
+#include <QDateTime>
+
+CommitOid CommitRow::oid() const
+{
+   return mWip ? mWip->oid() : mStore->oid(mIdx);
+}
+
+QString CommitRow::sha() const
+{
+   return mWip ? mWip->sha() : mStore->sha(mIdx);
+}
+
+QString CommitRow::shortLog() const
+{
+   return mWip ? mWip->shortLog() : mStore->shortLog(mIdx);
+}
+
+QString CommitRow::author() const
+{
+   return mWip ? mWip->author() : mStore->author(mIdx);
+}
+
+qint64 CommitRow::authorDate() const
+{
+   return mWip ? mWip->authorDate().toLongLong() : mStore->date(mIdx);
+}
+
+bool CommitRow::isSigned() const
+{
+   return mWip ? mWip->isSigned() : mStore->isSigned(mIdx);
+}
+
+QString CommitRow::getGpgKey() const
+{
+   return mWip ? mWip->getGpgKey() : mStore->gpgKey(mIdx);
+}
+
+QString CommitRow::shortAuthor() const
+{
+   return mDisplay ? mDisplay->author(mIdx) : CommitDisplayData::shortAuthor(author());
+}
+
+QString CommitRow::dateText() const
+{
+   return mDisplay ? mDisplay->date(mIdx) : QDateTime::fromSecsSinceEpoch(authorDate()).toString("dd MMM yyyy hh:mm");
+}
+
+QString CommitRow::longDateText() const
+{
+   return mDisplay ? mDisplay->longDate(mIdx)
+                   : QDateTime::fromSecsSinceEpoch(authorDate()).toString("dd MMM yyyy - hh:mm");
+}
+
+QString CommitRow::timeText() const
+{
+   return mDisplay ? mDisplay->time(mIdx) : QDateTime::fromSecsSinceEpoch(authorDate()).toString("hh:mm");
+}
+
+qint64 CommitRow::day() const
+{
+   return mDisplay ? mDisplay->day(mIdx) : QDateTime::fromSecsSinceEpoch(authorDate()).date().toJulianDay();
+}
+
+bool CommitRow::isSameDayAsPrevious() const
+{
+   return mDisplay && mDisplay->isSameDayAsPrevious(mIdx);
+}
+
+int CommitRow::parentsCount() const
+{
+   return mWip ? mWip->parentsCount() : mStore->parentsCount(mIdx);
+}
+
+int CommitRow::getLanesCount() const
+{
+   return mWip ? mWip->getLanesCount() : mStore->lanesCount(mIdx);
+}
+
+Lane CommitRow::getLane(int i) const
+{
+   return mWip ? mWip->getLane(i) : mStore->lane(mIdx, i);
+}
+
+LaneRow CommitRow::getLanes() const
+{
+   LaneRow lanes;
+
+   if (mWip)
+   {
+      const auto wipLanes = mWip->getLanes();
+      lanes.append(wipLanes.constData(), wipLanes.count());
+   }
+   else
+      mStore->lanes(mIdx, lanes);
+
+   return lanes;
+}
+
+int CommitRow::getActiveLane() const
+{
+   const auto lanes = getLanes();
+
+   for (auto i = 0; i < lanes.count(); ++i)
+   {
+      if (lanes.at(i).isActive())
+         return i;
+   }
+
+   return -1;
+}
+
+QStringList CommitRow::getReferences(References::Type type) const
+{
+   return mReferences ? mReferences->getReferences(type) : QStringList();
+}
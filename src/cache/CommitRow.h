@@ -0,0 +1,105 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+
+#include <CommitOid.h>
+#include <Lane.h>
+#include <References.h>
+
+#include <memory>
+
+class CommitInfo;
+class CommitDisplayData;
+class CommitStore;
+
+/**
+ * @brief The CommitRow class is a read-only handle to a row of the graph. It points to the data of the cache instead
+ * of copying it, so it's cheap to create for every cell the history view paints. The fields are read when they are
+ * requested.
+ *
+ * The handle keeps alive the data it points to, so it stays valid even if the cache is updated meanwhile.
+ *
+ * @class CommitRow CommitRow.h "CommitRow.h"
+ */
+class CommitRow
+{
+public:
+   CommitRow() = default;
+
+   bool isValid() const { return mWip || mIdx != -1; }
+   bool isWip() const { return mWip != nullptr; }
+
+   CommitOid oid() const;
+   QString sha() const;
+   QString shortLog() const;
+   QString author() const;
+   qint64 authorDate() const;
+   bool isSigned() const;
+   QString getGpgKey() const;
+
+   /**
+    * @brief The texts shown by the history view. They are precomputed in the background once the history is loaded,
+    * and formatted on demand until then.
+    */
+   QString shortAuthor() const;
+   QString dateText() const;
+   QString longDateText() const;
+   QString timeText() const;
+   /**
+    * @brief The day of the author date, as a Julian day.
+    */
+   qint64 day() const;
+   /**
+    * @brief Whether the commit is from the same day as the commit in the previous row of the graph. It's false while
+    * the texts are not precomputed.
+    */
+   bool isSameDayAsPrevious() const;
+
+   int parentsCount() const;
+   bool hasChilds() const { return mHasChilds; }
+
+   int getLanesCount() const;
+   Lane getLane(int i) const;
+   /**
+    * @brief Decodes all the lanes of the row at once. It's the way to read them when all of them are needed.
+    */
+   LaneRow getLanes() const;
+   int getActiveLane() const;
+
+   bool hasReferences() const { return mReferences && !mReferences->isEmpty(); }
+   QStringList getReferences(References::Type type) const;
+
+private:
+   friend class GitCache;
+
+   std::shared_ptr<const void> mOwner;
+   std::shared_ptr<const void> mDisplayOwner;
+   const CommitDisplayData *mDisplay = nullptr;
+   const CommitStore *mStore = nullptr;
+   const CommitInfo *mWip = nullptr;
+   const References *mReferences = nullptr;
+   int mIdx = -1;
+   bool mHasChilds = false;
+};
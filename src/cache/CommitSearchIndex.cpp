@@ -0,0 +1,123 @@
+#include "CommitSearchIndex.h"
+
+#include <CommitStore.h>
+
+#include <algorithm>
+
+namespace
+{
+quint64 trigram(const QChar *chars)
+{
+   return (static_cast<quint64>(chars[0].unicode()) << 32) | (static_cast<quint64>(chars[1].unicode()) << 16)
+       | chars[2].unicode();
+}
+}
+
+CommitSearchIndex::CommitSearchIndex(quint32 generation)
+   : mGeneration(generation)
+{
+}
+
+void CommitSearchIndex::update(const CommitStore &store)
+{
+   QVector<quint64> unsorted;
+   QVector<qint32> pending;
+
+   // The placeholders that were filled since the last update are indexed out of order.
+   for (auto idx : qAsConst(mPending))
+   {
+      if (store.isLoaded(idx))
+         addCommit(store, idx, unsorted);
+      else
+         pending.append(idx);
+   }
+
+   for (auto idx = mCount; idx < store.count(); ++idx)
+   {
+      if (store.isLoaded(idx))
+         addCommit(store, idx, unsorted);
+      else
+         pending.append(idx);
+   }
+
+   mPending = pending;
+   mCount = store.count();
+
+   std::sort(unsorted.begin(), unsorted.end());
+   unsorted.erase(std::unique(unsorted.begin(), unsorted.end()), unsorted.end());
+
+   for (auto key : qAsConst(unsorted))
+   {
+      auto &postings = mPostings[key];
+      std::sort(postings.begin(), postings.end());
+   }
+}
+
+QVector<qint32> CommitSearchIndex::candidates(const QString &text, int storeCount) const
+{
+   QVector<const QVector<qint32> *> postings;
+   postings.reserve(text.length());
+
+   for (auto i = 0; i + GRAM_LENGTH <= text.length(); ++i)
+   {
+      const auto iter = mPostings.constFind(trigram(text.constData() + i));
+
+      if (iter == mPostings.constEnd())
+      {
+         postings.clear();
+         break;
+      }
+
+      postings.append(&iter.value());
+   }
+
+   QVector<qint32> result;
+
+   if (!postings.isEmpty())
+   {
+      // The intersection starts from the shortest list so it only gets shorter.
+      std::sort(postings.begin(), postings.end(), [](const QVector<qint32> *first, const QVector<qint32> *second) {
+         return first->count() < second->count();
+      });
+
+      result = *postings.constFirst();
+
+      for (auto i = 1; i < postings.count() && !result.isEmpty(); ++i)
+      {
+         QVector<qint32> intersection;
+         std::set_intersection(result.cbegin(), result.cend(), postings.at(i)->cbegin(), postings.at(i)->cend(),
+                               std::back_inserter(intersection));
+         result = intersection;
+      }
+   }
+
+   // The commits the index doesn't know yet must be checked by the caller.
+   result.append(mPending);
+
+   for (auto idx = mCount; idx < storeCount; ++idx)
+      result.append(idx);
+
+   std::sort(result.begin(), result.end());
+
+   return result;
+}
+
+void CommitSearchIndex::addCommit(const CommitStore &store, int idx, QVector<quint64> &unsorted)
+{
+   const auto text = store.shortLog(idx) + QChar('\n') + store.longLog(idx) + QChar('\n') + store.author(idx);
+
+   for (auto i = 0; i + GRAM_LENGTH <= text.length(); ++i)
+   {
+      const auto key = trigram(text.constData() + i);
+      auto &postings = mPostings[key];
+
+      // A trigram repeated in the same commit is only added once.
+      if (!postings.isEmpty() && postings.constLast() == idx)
+         continue;
+
+      if (!postings.isEmpty() && postings.constLast() > idx)
+         unsorted.append(key);
+
+      postings.append(idx);
+   }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class CommitStore;
+
+/**
+ * @brief The CommitSearchIndex class is an inverted index of the trigrams of the short log, the long log and the
+ * author of the commits of a @ref CommitStore. It gives the commits that can contain a text without reading all of
+ * them, so the caller only has to check a few candidates.
+ *
+ * The index refers to the commits by their index in the store, so it can be updated with the commits added to the
+ * same store since the last update.
+ *
+ * @class CommitSearchIndex CommitSearchIndex.h "CommitSearchIndex.h"
+ */
+class CommitSearchIndex
+{
+public:
+   /**
+    * @brief The length of the texts the index is built from. The shorter ones can't use the index.
+    */
+   static constexpr int GRAM_LENGTH = 3;
+
+   /**
+    * @brief Creates an empty index.
+    *
+    * @param generation Identifies the store the index is built from.
+    */
+   explicit CommitSearchIndex(quint32 generation = 0);
+
+   quint32 generation() const { return mGeneration; }
+
+   /**
+    * @brief Adds the commits of the store that are not indexed yet.
+    *
+    * @param store The store the index is built from.
+    */
+   void update(const CommitStore &store);
+
+   /**
+    * @brief Returns the commits that can contain the text. The commits that were placeholders when the index was
+    * updated and the ones added later are always candidates.
+    *
+    * @param text The text to search. It must have at least @ref GRAM_LENGTH characters.
+    * @param storeCount The number of indices of the store the candidates are checked against.
+    * @return QVector<qint32> The indices of the candidates in the store, sorted.
+    */
+   QVector<qint32> candidates(const QString &text, int storeCount) const;
+
+private:
+   quint32 mGeneration = 0;
+   int mCount = 0;
+   QVector<qint32> mPending;
+   QHash<quint64, QVector<qint32>> mPostings;
+
+   void addCommit(const CommitStore &store, int idx, QVector<quint64> &unsorted);
+};
@@ -0,0 +1,482 @@
+#include "CommitStore.h"
+
+#include <LaneType.h>
+
+#include <algorithm>
+#include <type_traits>
+
+namespace
+{
+// The lanes are one byte per lane. A byte with the high bit set starts a run of lanes of the same type: the low bits
+// are the type and the next byte is the length. Wide graphs have long runs of empty and inactive lanes.
+const quint8 RUN_FLAG = 0x80;
+const int MIN_RUN = 3;
+const int MAX_RUN = 255;
+
+void encodeLanes(const QVector<Lane> &lanes, QVarLengthArray<char, 256> &bytes)
+{
+   for (auto i = 0; i < lanes.count();)
+   {
+      const auto type = static_cast<quint8>(lanes.at(i).getType());
+      auto run = 1;
+
+      while (i + run < lanes.count() && run < MAX_RUN && lanes.at(i + run).getType() == lanes.at(i).getType())
+         ++run;
+
+      if (run >= MIN_RUN)
+      {
+         bytes.append(static_cast<char>(RUN_FLAG | type));
+         bytes.append(static_cast<char>(run));
+      }
+      else
+      {
+         for (auto j = 0; j < run; ++j)
+            bytes.append(static_cast<char>(type));
+      }
+
+      i += run;
+   }
+}
+
+template<class T>
+void writeArray(QDataStream &out, const QVector<T> &array)
+{
+   static_assert(std::is_trivially_copyable<T>::value, "The arrays are written as raw memory");
+
+   out << static_cast<qint32>(array.count());
+   out.writeRawData(reinterpret_cast<const char *>(array.constData()), array.count() * static_cast<int>(sizeof(T)));
+}
+
+template<class T>
+bool readArray(QDataStream &in, QVector<T> &array, int expectedCount = -1)
+{
+   qint32 count = 0;
+   in >> count;
+
+   if (in.status() != QDataStream::Ok || count < 0 || (expectedCount != -1 && count != expectedCount)
+       || count > in.device()->bytesAvailable() / static_cast<int>(sizeof(T)))
+   {
+      return false;
+   }
+
+   const auto bytes = count * static_cast<int>(sizeof(T));
+   array.resize(count);
+
+   return in.readRawData(reinterpret_cast<char *>(array.data()), bytes) == bytes;
+}
+
+template<class Container>
+void decodeLanes(const char *data, int size, Container &lanes)
+{
+   for (auto i = 0; i < size; ++i)
+   {
+      const auto byte = static_cast<quint8>(data[i]);
+      const auto type = static_cast<LaneType>(byte & ~RUN_FLAG);
+
+      if (byte & RUN_FLAG)
+      {
+         const auto run = static_cast<quint8>(data[++i]);
+
+         for (auto j = 0; j < run; ++j)
+            lanes.append(Lane(type));
+      }
+      else
+         lanes.append(Lane(type));
+   }
+}
+}
+
+void CommitStore::clear()
+{
+   *this = CommitStore();
+}
+
+void CommitStore::reserve(int size)
+{
+   mOids.reserve(size);
+   mFlags.reserve(size);
+   mBoundaries.reserve(size);
+   mDates.reserve(size);
+   mAuthors.reserve(size);
+   mCommitters.reserve(size);
+   mGpgKeys.reserve(size);
+   mTextOffset.reserve(size);
+   mShortLogSize.reserve(size);
+   mLongLogSize.reserve(size);
+   mParentsOffset.reserve(size);
+   mParentsCount.reserve(size);
+   mLanesOffset.reserve(size);
+   mLanesSize.reserve(size);
+   mLanesCount.reserve(size);
+   mRows.reserve(size);
+   mParents.reserve(size);
+   mIndex.reserve(size);
+}
+
+void CommitStore::write(QDataStream &out) const
+{
+   updateSortedIndex();
+
+   writeArray(out, mOids);
+   writeArray(out, mFlags);
+   writeArray(out, mBoundaries);
+   writeArray(out, mDates);
+   writeArray(out, mAuthors);
+   writeArray(out, mCommitters);
+   writeArray(out, mGpgKeys);
+   writeArray(out, mTextOffset);
+   writeArray(out, mShortLogSize);
+   writeArray(out, mLongLogSize);
+   writeArray(out, mParentsOffset);
+   writeArray(out, mParentsCount);
+   writeArray(out, mLanesOffset);
+   writeArray(out, mLanesSize);
+   writeArray(out, mLanesCount);
+   writeArray(out, mRows);
+   writeArray(out, mSortedIndex);
+   writeArray(out, mParents);
+
+   out << mRowsOffset << mText << mLanes << mUnusedLanes << mIdentities;
+}
+
+bool CommitStore::read(QDataStream &in)
+{
+   clear();
+
+   auto success = readArray(in, mOids);
+   const auto size = mOids.count();
+
+   success = success && readArray(in, mFlags, size) && readArray(in, mBoundaries, size) && readArray(in, mDates, size)
+       && readArray(in, mAuthors, size) && readArray(in, mCommitters, size) && readArray(in, mGpgKeys, size)
+       && readArray(in, mTextOffset, size) && readArray(in, mShortLogSize, size) && readArray(in, mLongLogSize, size)
+       && readArray(in, mParentsOffset, size) && readArray(in, mParentsCount, size)
+       && readArray(in, mLanesOffset, size) && readArray(in, mLanesSize, size) && readArray(in, mLanesCount, size)
+       && readArray(in, mRows, size) && readArray(in, mSortedIndex, size) && readArray(in, mParents);
+
+   if (success)
+   {
+      in >> mRowsOffset >> mText >> mLanes >> mUnusedLanes >> mIdentities;
+      success = in.status() == QDataStream::Ok;
+   }
+
+   const auto isIdentity = [this](qint32 id) { return id >= 0 && id < mIdentities.count(); };
+
+   // The offsets are checked once here so the accessors can trust them.
+   for (auto idx = 0; success && idx < size; ++idx)
+   {
+      success = mOids.at(idx).isValid() && mSortedIndex.at(idx) >= 0 && mSortedIndex.at(idx) < size
+          && mTextOffset.at(idx) >= 0 && mShortLogSize.at(idx) >= 0 && mLongLogSize.at(idx) >= 0
+          && qint64(mTextOffset.at(idx)) + mShortLogSize.at(idx) + mLongLogSize.at(idx) <= mText.size()
+          && mParentsOffset.at(idx) >= 0 && mParentsOffset.at(idx) + mParentsCount.at(idx) <= mParents.count()
+          && mLanesOffset.at(idx) >= 0 && mLanesOffset.at(idx) + mLanesSize.at(idx) <= mLanes.size()
+          && (!isLoaded(idx)
+              || (isIdentity(mAuthors.at(idx)) && isIdentity(mCommitters.at(idx))
+                  && (mGpgKeys.at(idx) == -1 || isIdentity(mGpgKeys.at(idx)))));
+   }
+
+   for (auto i = 0; success && i < mParents.count(); ++i)
+      success = mParents.at(i) >= 0 && mParents.at(i) < size;
+
+   if (!success)
+   {
+      clear();
+      return false;
+   }
+
+   mIndex.reserve(size);
+
+   for (auto idx = 0; idx < size; ++idx)
+      mIndex.insert(mOids.at(idx), idx);
+
+   mIdentityIds.reserve(mIdentities.count());
+
+   for (auto id = 0; id < mIdentities.count(); ++id)
+      mIdentityIds.insert(mIdentities.at(id), id);
+
+   return true;
+}
+
+int CommitStore::add(const CommitInfo &commit, const QVector<Lane> &lanes)
+{
+   const auto oid = commit.oid();
+
+   if (!oid.isValid())
+      return -1;
+
+   const auto idx = indexFor(oid);
+
+   if (isLoaded(idx))
+      return -1;
+
+   auto flags = static_cast<quint8>(LOADED);
+
+   if (commit.isSigned())
+      flags |= SIGNED;
+
+   if (commit.isLongLogLoaded())
+      flags |= LONG_LOG_LOADED;
+
+   const auto shortLog = commit.shortLog().toUtf8();
+   const auto longLog = commit.longLog().toUtf8();
+
+   // The placeholder already knows if the commit has children.
+   mFlags[idx] = (mFlags.at(idx) & HAS_CHILDS) | flags;
+   mBoundaries[idx] = commit.boundary().toLatin1();
+   mDates[idx] = commit.authorDate().toLongLong();
+   mAuthors[idx] = identityId(commit.author());
+   mCommitters[idx] = identityId(commit.committer());
+   mGpgKeys[idx] = commit.isSigned() ? identityId(commit.getGpgKey()) : -1;
+   mTextOffset[idx] = mText.size();
+   mShortLogSize[idx] = shortLog.size();
+   mLongLogSize[idx] = longLog.size();
+   mText.append(shortLog);
+   mText.append(longLog);
+
+   // The placeholders of the parents are created before the offset is taken, they don't have parents on their own.
+   const auto parents = commit.parentOids();
+   QVector<qint32> parentIndices;
+   parentIndices.reserve(parents.count());
+
+   for (const auto &parent : parents)
+      parentIndices.append(indexFor(parent));
+
+   mParentsOffset[idx] = mParents.count();
+   mParentsCount[idx] = static_cast<quint16>(parentIndices.count());
+
+   for (auto parentIdx : qAsConst(parentIndices))
+   {
+      mParents.append(parentIdx);
+      mFlags[parentIdx] |= HAS_CHILDS;
+   }
+
+   setLanes(idx, lanes);
+
+   return idx;
+}
+
+int CommitStore::indexOf(const CommitOid &oid) const
+{
+   return mIndex.value(oid, -1);
+}
+
+int CommitStore::indexOfPrefix(const QString &sha, bool *ambiguous) const
+{
+   if (ambiguous)
+      *ambiguous = false;
+
+   if (sha.length() == CommitOid::HEX_LENGTH)
+   {
+      const auto idx = indexOf(CommitOid::fromString(sha));
+      return idx != -1 && isLoaded(idx) ? idx : -1;
+   }
+
+   const auto prefix = CommitOid::fromPrefix(sha);
+
+   if (!prefix.isValid())
+      return -1;
+
+   updateSortedIndex();
+
+   // The prefix has zeros in the digits it doesn't have, so the first match is the lower bound and the rest follow it.
+   auto iter = std::lower_bound(mSortedIndex.cbegin(), mSortedIndex.cend(), prefix,
+                                [this](qint32 idx, const CommitOid &oid) { return mOids.at(idx) < oid; });
+   auto found = -1;
+
+   for (; iter != mSortedIndex.cend() && mOids.at(*iter).startsWith(prefix, sha.length()); ++iter)
+   {
+      if (!isLoaded(*iter))
+         continue;
+
+      if (found != -1)
+      {
+         if (ambiguous)
+            *ambiguous = true;
+
+         return -1;
+      }
+
+      found = *iter;
+   }
+
+   return found;
+}
+
+CommitInfo CommitStore::commit(int idx) const
+{
+   if (idx < 0 || idx >= count() || !isLoaded(idx))
+      return CommitInfo();
+
+   QVector<CommitOid> parents;
+   parents.reserve(mParentsCount.at(idx));
+
+   for (auto i = 0; i < mParentsCount.at(idx); ++i)
+      parents.append(mOids.at(parent(idx, i)));
+
+   const auto flags = mFlags.at(idx);
+   const auto gpgKey = mGpgKeys.at(idx);
+
+   CommitInfo commit(mOids.at(idx), parents, QChar::fromLatin1(mBoundaries.at(idx)), committer(idx),
+                     QDateTime::fromSecsSinceEpoch(mDates.at(idx)), author(idx), shortLog(idx),
+                     longLogUtf8(idx), flags & SIGNED,
+                     gpgKey != -1 ? mIdentities.at(gpgKey) : QString());
+   commit.setLongLogLoaded(flags & LONG_LOG_LOADED);
+   commit.setLanes(lanes(idx));
+   commit.setHasChilds(hasChilds(idx));
+
+   return commit;
+}
+
+QString CommitStore::shortLog(int idx) const
+{
+   return QString::fromUtf8(mText.constData() + mTextOffset.at(idx), mShortLogSize.at(idx));
+}
+
+QString CommitStore::longLog(int idx) const
+{
+   return QString::fromUtf8(mText.constData() + mTextOffset.at(idx) + mShortLogSize.at(idx), mLongLogSize.at(idx));
+}
+
+QByteArray CommitStore::longLogUtf8(int idx) const
+{
+   return mText.mid(mTextOffset.at(idx) + mShortLogSize.at(idx), mLongLogSize.at(idx));
+}
+
+void CommitStore::setLanes(int idx, const QVector<Lane> &lanes)
+{
+   QVarLengthArray<char, 256> bytes;
+   encodeLanes(lanes, bytes);
+
+   const auto lanesSize = mLanesSize.at(idx);
+
+   // The lanes are rewritten in place if they fit. Otherwise the old bytes are left unused until the buffer is
+   // compacted.
+   if (bytes.count() > lanesSize)
+   {
+      mUnusedLanes += lanesSize;
+      mLanesOffset[idx] = mLanes.size();
+      mLanes.resize(mLanes.size() + bytes.count());
+   }
+   else
+      mUnusedLanes += lanesSize - bytes.count();
+
+   mLanesSize[idx] = static_cast<quint16>(bytes.count());
+   mLanesCount[idx] = static_cast<quint16>(lanes.count());
+
+   std::copy(bytes.constBegin(), bytes.constEnd(), mLanes.data() + mLanesOffset.at(idx));
+
+   if (mUnusedLanes > mLanes.size() / 2)
+      compactLanes();
+}
+
+QVector<Lane> CommitStore::lanes(int idx) const
+{
+   QVector<Lane> lanes;
+   lanes.reserve(mLanesCount.at(idx));
+
+   decodeLanes(mLanes.constData() + mLanesOffset.at(idx), mLanesSize.at(idx), lanes);
+
+   return lanes;
+}
+
+void CommitStore::lanes(int idx, LaneRow &lanes) const
+{
+   lanes.clear();
+   lanes.reserve(mLanesCount.at(idx));
+
+   decodeLanes(mLanes.constData() + mLanesOffset.at(idx), mLanesSize.at(idx), lanes);
+}
+
+Lane CommitStore::lane(int idx, int laneIdx) const
+{
+   const auto data = mLanes.constData() + mLanesOffset.at(idx);
+   const auto size = mLanesSize.at(idx);
+
+   for (auto i = 0, first = 0; i < size; ++i)
+   {
+      const auto byte = static_cast<quint8>(data[i]);
+      const auto run = byte & RUN_FLAG ? static_cast<quint8>(data[++i]) : 1;
+
+      if (laneIdx < first + run)
+         return Lane(static_cast<LaneType>(byte & ~RUN_FLAG));
+
+      first += run;
+   }
+
+   return Lane(LaneType::EMPTY);
+}
+
+int CommitStore::indexFor(const CommitOid &oid)
+{
+   if (const auto iter = mIndex.constFind(oid); iter != mIndex.constEnd())
+      return iter.value();
+
+   const auto idx = mOids.count();
+
+   mOids.append(oid);
+   mFlags.append(0);
+   mBoundaries.append(0);
+   mDates.append(0);
+   mAuthors.append(-1);
+   mCommitters.append(-1);
+   mGpgKeys.append(-1);
+   mTextOffset.append(0);
+   mShortLogSize.append(0);
+   mLongLogSize.append(0);
+   mParentsOffset.append(0);
+   mParentsCount.append(0);
+   mLanesOffset.append(0);
+   mLanesSize.append(0);
+   mLanesCount.append(0);
+   mRows.append(NO_ROW);
+   mIndex.insert(oid, idx);
+
+   return idx;
+}
+
+qint32 CommitStore::identityId(const QString &identity)
+{
+   if (const auto iter = mIdentityIds.constFind(identity); iter != mIdentityIds.constEnd())
+      return iter.value();
+
+   const auto id = mIdentities.count();
+
+   mIdentities.append(identity);
+   mIdentityIds.insert(identity, id);
+
+   return id;
+}
+
+void CommitStore::compactLanes()
+{
+   QByteArray lanes;
+   lanes.reserve(mLanes.size() - mUnusedLanes);
+
+   for (auto i = 0; i < count(); ++i)
+   {
+      const auto offset = lanes.size();
+
+      lanes.append(mLanes.constData() + mLanesOffset.at(i), mLanesSize.at(i));
+      mLanesOffset[i] = offset;
+   }
+
+   mLanes = lanes;
+   mUnusedLanes = 0;
+}
+
+void CommitStore::updateSortedIndex() const
+{
+   const auto sortedCount = mSortedIndex.count();
+
+   if (sortedCount == count())
+      return;
+
+   mSortedIndex.reserve(count());
+
+   for (auto i = sortedCount; i < count(); ++i)
+      mSortedIndex.append(i);
+
+   const auto lessThan = [this](qint32 first, qint32 second) { return mOids.at(first) < mOids.at(second); };
+
+   std::sort(mSortedIndex.begin() + sortedCount, mSortedIndex.end(), lessThan);
+   std::inplace_merge(mSortedIndex.begin(), mSortedIndex.begin() + sortedCount, mSortedIndex.end(), lessThan);
+}
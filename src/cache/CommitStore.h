@@ -0,0 +1,234 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitInfo.h>
+#include <CommitOid.h>
+#include <Lane.h>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QHash>
+#include <QVector>
+
+#include <limits>
+
+/**
+ * @brief The CommitStore class keeps the commits of the graph in contiguous arrays (one per field) instead of one
+ * object per commit. The object ids are stored in binary, the parents are indices of other commits, the
+ * authors and committers are interned and the messages and lanes are stored in a single buffer each. The lanes use one
+ * byte per lane and the runs of lanes of the same type are run-length encoded.
+ *
+ * A commit gets its index the first time it's seen, either as a commit or as the parent of one. Until the commit
+ * itself is added the index is a placeholder without data, so the parents can refer to commits that arrive later.
+ *
+ * The commits are read back as @ref CommitInfo values built on demand.
+ *
+ * @class CommitStore CommitStore.h "CommitStore.h"
+ */
+class CommitStore
+{
+public:
+   /**
+    * @brief Removes all the commits and releases the memory.
+    */
+   void clear();
+   /**
+    * @brief Reserves the memory for the given number of commits.
+    *
+    * @param size The number of commits.
+    */
+   void reserve(int size);
+
+   /**
+    * @brief Writes the arrays of the store as they are in memory, so they can be read back without parsing the
+    * commits again. The data depends on the byte order of the machine.
+    *
+    * @param out The stream where the store is written.
+    */
+   void write(QDataStream &out) const;
+   /**
+    * @brief Reads the arrays written by @ref write. The tables to look up the commits are built again from them.
+    *
+    * @param in The stream the store is read from.
+    * @return True if the data is complete and consistent. Otherwise the store is left empty.
+    */
+   bool read(QDataStream &in);
+
+   /**
+    * @brief Adds a commit to the store.
+    *
+    * @param commit The commit information.
+    * @param lanes The lanes of the commit in the graph.
+    * @return int The index of the commit, or -1 if it was already in the store or it's not valid.
+    */
+   int add(const CommitInfo &commit, const QVector<Lane> &lanes);
+
+   /**
+    * @brief The number of indices used, including the placeholders of the parents that were not added yet.
+    */
+   int count() const { return mOids.count(); }
+   /**
+    * @brief Returns the index of a commit.
+    *
+    * @param oid The object id of the commit.
+    * @return int The index or -1 if the commit is not in the store.
+    */
+   int indexOf(const CommitOid &oid) const;
+   /**
+    * @brief Returns the index of a commit, creating a placeholder for it if it's not in the store yet.
+    *
+    * @param oid The object id of the commit.
+    * @return int The index.
+    */
+   int indexFor(const CommitOid &oid);
+   /**
+    * @brief Returns the index of the commit which SHA starts with the given text. The lookup is a binary search over
+    * the object ids sorted.
+    *
+    * @param sha The full SHA or the beginning of it.
+    * @param ambiguous Optional output set to true if more than one commit starts with @p sha.
+    * @return int The index, or -1 if no commit or more than one match.
+    */
+   int indexOfPrefix(const QString &sha, bool *ambiguous = nullptr) const;
+   /**
+    * @brief Whether the index belongs to a commit that was added or to a placeholder.
+    */
+   bool isLoaded(int idx) const { return mFlags.at(idx) & LOADED; }
+   /**
+    * @brief Adds the commits added since the last call to the sorted index used by @ref indexOfPrefix. It's done on
+    * demand by the lookups, but a store shared between threads must have it updated before it's shared.
+    */
+   void updateSortedIndex() const;
+
+   /**
+    * @brief Builds the information of the commit.
+    *
+    * @param idx The index of the commit.
+    * @return CommitInfo The commit with its lanes. It doesn't have references.
+    */
+   CommitInfo commit(int idx) const;
+
+   CommitOid oid(int idx) const { return mOids.at(idx); }
+   QString sha(int idx) const { return mOids.at(idx).toString(); }
+   QString shortLog(int idx) const;
+   QString longLog(int idx) const;
+   /**
+    * @brief The long log as it's stored, without decoding it.
+    */
+   QByteArray longLogUtf8(int idx) const;
+   char boundary(int idx) const { return mBoundaries.at(idx); }
+   QString author(int idx) const { return mIdentities.at(mAuthors.at(idx)); }
+   QString committer(int idx) const { return mIdentities.at(mCommitters.at(idx)); }
+   qint64 date(int idx) const { return mDates.at(idx); }
+   bool isSigned(int idx) const { return mFlags.at(idx) & SIGNED; }
+   bool isLongLogLoaded(int idx) const { return mFlags.at(idx) & LONG_LOG_LOADED; }
+   QString gpgKey(int idx) const { return mGpgKeys.at(idx) != -1 ? mIdentities.at(mGpgKeys.at(idx)) : QString(); }
+
+   int parentsCount(int idx) const { return mParentsCount.at(idx); }
+   /**
+    * @brief The index of a parent. It can be a placeholder if the parent is not part of the graph.
+    */
+   int parent(int idx, int parentIdx) const { return mParents.at(mParentsOffset.at(idx) + parentIdx); }
+   bool hasChilds(int idx) const { return mFlags.at(idx) & HAS_CHILDS; }
+
+   /**
+    * @brief The row of the commit in the graph, or -1 if it's not shown.
+    */
+   int row(int idx) const { return mRows.at(idx) != NO_ROW ? mRows.at(idx) + mRowsOffset : -1; }
+   void setRow(int idx, int row) { mRows[idx] = row - mRowsOffset; }
+   /**
+    * @brief Moves down the rows of all the commits, so new rows can be added on top without rewriting them.
+    *
+    * @param count The number of rows added on top.
+    */
+   void shiftRows(int count) { mRowsOffset += count; }
+
+   /**
+    * @brief Replaces the lanes of a commit.
+    *
+    * @param idx The index of the commit.
+    * @param lanes The new lanes.
+    */
+   void setLanes(int idx, const QVector<Lane> &lanes);
+   QVector<Lane> lanes(int idx) const;
+   /**
+    * @brief Decodes the lanes of a commit into a buffer that lives in the stack for the usual graph widths.
+    *
+    * @param idx The index of the commit.
+    * @param lanes The buffer where the lanes are decoded.
+    */
+   void lanes(int idx, LaneRow &lanes) const;
+   int lanesCount(int idx) const { return mLanesCount.at(idx); }
+   /**
+    * @brief Reads a single lane of a commit without decoding the rest.
+    */
+   Lane lane(int idx, int laneIdx) const;
+
+private:
+   static constexpr qint32 NO_ROW = std::numeric_limits<qint32>::min();
+
+   enum Flag : quint8
+   {
+      LOADED = 1,
+      SIGNED = 2,
+      LONG_LOG_LOADED = 4,
+      // Set in the parents when a commit is added, so it's kept in the placeholders.
+      HAS_CHILDS = 8
+   };
+
+   // One entry per index.
+   QVector<CommitOid> mOids;
+   QVector<quint8> mFlags;
+   QVector<char> mBoundaries;
+   QVector<qint64> mDates;
+   QVector<qint32> mAuthors;
+   QVector<qint32> mCommitters;
+   QVector<qint32> mGpgKeys;
+   QVector<qint32> mTextOffset;
+   QVector<qint32> mShortLogSize;
+   QVector<qint32> mLongLogSize;
+   QVector<qint32> mParentsOffset;
+   QVector<quint16> mParentsCount;
+   QVector<qint32> mLanesOffset;
+   QVector<quint16> mLanesSize;
+   QVector<quint16> mLanesCount;
+   // The rows are stored relative to the offset, so the commits added on top have lower values.
+   QVector<qint32> mRows;
+   qint32 mRowsOffset = 0;
+
+   // Shared buffers the entries point to.
+   QVector<qint32> mParents;
+   QByteArray mText;
+   QByteArray mLanes;
+   qint32 mUnusedLanes = 0;
+   QVector<QString> mIdentities;
+   QHash<QString, qint32> mIdentityIds;
+   QHash<CommitOid, qint32> mIndex;
+   // The indices sorted by object id. The ones added since the last prefix lookup are merged in the next one.
+   mutable QVector<qint32> mSortedIndex;
+
+   qint32 identityId(const QString &identity);
+   void compactLanes();
+};
@@ -4,19 +4,35 @@
 
 #include <QLogger.h>
 
+#include <QSet>
+#include <QBitArray>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <limits>
+
 using namespace QLogger;
 using namespace GitServer;
 
+namespace
+{
+// The id of the WIP in the lanes engine. The commits use their index in the store.
+const qint32 WIP_ID = -2;
+}
+
 GitCache::GitCache(QObject *parent)
    : QObject(parent)
    , mMutex(QMutex::Recursive)
 {
+   setRevisionFilesBudget(DEFAULT_REVISION_FILES_BUDGET_MB);
 }
 
 GitCache::~GitCache()
 {
-   mCommits.clear();
-   mCommitsMap.clear();
+   mSearchIndexFuture.waitForFinished();
+
+   mRows.clear();
+   mStore.clear();
    mReferences.clear();
 }
 
@@ -28,159 +44,589 @@ void GitCache::setup(const WipRevisionInfo &wipInfo, const QList<CommitInfo> &co
 
    QLog_Debug("Git", QString("Configuring the cache for {%1} elements.").arg(totalCommits));
 
+   reset();
+
+   mStore.clear();
+   mStore.reserve(totalCommits);
+
+   mRows.clear();
+   mRows.reserve(totalCommits);
+   mRows.append(-1);
+
+   QLog_Debug("Git", QString("Adding WIP revision."));
+
+   insertWipRevision(wipInfo.parentSha, wipInfo.diffIndex, wipInfo.diffIndexCached);
+
+   // The graph starts below the WIP, so the engine begins with the lane that goes from the WIP to its parent.
+   mLanes.init(WIP_ID);
+   calculateWipLanes(mLanes, wipInfo.parentSha);
+   mLanesHeadSha = wipInfo.parentSha;
+
+   QLog_Debug("Git", QString("Adding commited revisions."));
+
+   for (const auto &commit : commits)
+   {
+      if (commit.isValid())
+         insertCommitInfo(commit);
+   }
+
+   publishSnapshot();
+}
+
+void GitCache::setup(const CommitStore &store, const GraphRows &rows, const QString &lanesHeadSha)
+{
+   QMutexLocker lock(&mMutex);
+
+   QLog_Debug("Git", QString("Configuring the cache for {%1} stored elements.").arg(rows.count()));
+
+   reset();
+
+   mStore = store;
+   mRows = rows;
+   mWip = CommitInfo();
+
+   // The lanes are the ones stored. The engine is only used again once new commits are prepended, and that starts from
+   // the HEAD the lanes were calculated for.
+   mLanes.init(WIP_ID);
+   calculateWipLanes(mLanes, lanesHeadSha);
+   mLanesHeadSha = lanesHeadSha;
+}
+
+void GitCache::reset()
+{
    mConfigured = false;
 
-   mDirNames.clear();
-   mFileNames.clear();
-   mRevisionFilesMap.clear();
+   {
+      QMutexLocker filesLock(&mRevisionFilesMutex);
+
+      mPathTable = QSharedPointer<PathTable>::create();
+      mPathTableCompactedBytes = 0;
+      mRevisionFilesCache.clear();
+      mRevisionFilesUses.clear();
+      mWipRevisionFiles.clear();
+   }
+
    mLanes.clear();
 
-   for (auto reference : qAsConst(mReferences))
-      reference->clearReferences();
+   clearReferences();
 
-   mReferences.clear();
+   ++mGeneration;
+}
 
-   if (mCommitsMap.isEmpty())
-      mCommitsMap.reserve(totalCommits);
+void GitCache::appendCommits(const QList<CommitInfo> &commits)
+{
+   QMutexLocker lock(&mMutex);
 
-   if (mCommits.isEmpty() || totalCommits > mCommits.count())
-      mCommits.resize(totalCommits);
-   else if (totalCommits < mCommits.count())
-   {
-      const auto commitsToRemove = std::abs(totalCommits - mCommits.count());
+   QLog_Debug("Git", QString("Appending {%1} revisions to the cache.").arg(commits.count()));
 
-      for (auto i = 0; i < commitsToRemove; ++i)
-         mCommits.takeLast();
+   mRows.reserve(mRows.count() + commits.count());
+
+   for (const auto &commit : commits)
+   {
+      if (commit.isValid())
+         insertCommitInfo(commit);
    }
 
-   QLog_Debug("Git", QString("Adding WIP revision."));
+   publishSnapshot();
+}
 
-   insertWipRevision(wipInfo.parentSha, wipInfo.diffIndex, wipInfo.diffIndexCached);
+void GitCache::appendPage(const QList<CommitInfo> &commits)
+{
+   QMutexLocker lock(&mMutex);
 
-   auto count = 1;
+   QLog_Debug("Git", QString("Appending a page of {%1} revisions to the cache.").arg(commits.count()));
 
-   QLog_Debug("Git", QString("Adding commited revisions."));
+   // The pages arrive once the cache is configured. The lanes and the pending children continue from the previous page.
+   mRows.reserve(mRows.count() + commits.count());
 
    for (const auto &commit : commits)
    {
       if (commit.isValid())
+         addCommitInfo(commit);
+   }
+
+   publishSnapshot();
+   updateSearchIndex();
+}
+
+void GitCache::prependCommits(const WipRevisionInfo &wipInfo, const QList<CommitInfo> &commits)
+{
+   QMutexLocker lock(&mMutex);
+
+   QLog_Debug("Git", QString("Adding {%1} new revisions on top of the cache.").arg(commits.count()));
+
+   if (mRows.isEmpty())
+      return;
+
+   const auto &headSha = wipInfo.parentSha;
+
+   // Two lane engines go through the graph: one with the rows as they were and one with the new commits on top. Once
+   // both have the same state after the same commit, the lanes of the remaining rows are the ones already calculated.
+   Lanes previousLanes;
+   previousLanes.init(WIP_ID);
+   calculateWipLanes(previousLanes, mLanesHeadSha);
+
+   Lanes lanes;
+   lanes.init(WIP_ID);
+   calculateWipLanes(lanes, headSha);
+
+   QVector<qint32> newRows;
+   newRows.reserve(commits.count());
+
+   // The store links the new commits with their parents and children when they are added.
+   for (const auto &commit : commits)
+   {
+      if (!commit.isValid())
+         continue;
+
+      if (const auto idx = mStore.indexOf(commit.oid()); idx != -1 && mStore.isLoaded(idx))
+         continue;
+
+      if (const auto idx = mStore.add(commit, QVector<Lane>()); idx != -1)
       {
-         insertCommitInfo(commit, count);
-         ++count;
+         mStore.setLanes(idx, calculateLanes(lanes, idx));
+         newRows.append(idx);
       }
    }
+
+   auto converged = previousLanes == lanes;
+   auto recalculated = 0;
+
+   for (auto row = 1; !converged && row < mRows.count(); ++row)
+   {
+      const auto idx = mRows.at(row);
+
+      calculateLanes(previousLanes, idx);
+      mStore.setLanes(idx, calculateLanes(lanes, idx));
+      converged = previousLanes == lanes;
+      ++recalculated;
+   }
+
+   // Without convergence the engine used for the new graph is the one that knows the state of the last row.
+   if (!converged)
+      mLanes = lanes;
+
+   mLanesHeadSha = headSha;
+
+   // The rows that were already there move down by an offset, only the new ones are written.
+   mStore.shiftRows(newRows.count());
+   mRows.prepend(newRows);
+
+   for (auto i = 0; i < newRows.count(); ++i)
+      mStore.setRow(newRows.at(i), i + 1);
+
+   insertWipRevision(wipInfo.parentSha, wipInfo.diffIndex, wipInfo.diffIndexCached);
+
+   QLog_Debug("Git", QString("The lanes of {%1} existing revisions have been recalculated.").arg(recalculated));
 }
 
-CommitInfo GitCache::getCommitInfoByRow(int row)
+void GitCache::setConfigurationDone()
 {
    QMutexLocker lock(&mMutex);
 
-   const auto commit = row >= 0 && row < mCommits.count() ? mCommits.at(row) : nullptr;
+   mConfigured = true;
 
-   return commit ? *commit : CommitInfo();
+   publishSnapshot();
+   updateSearchIndex();
 }
 
-int GitCache::getCommitPos(const QString &sha)
+void GitCache::publishSnapshot()
 {
    QMutexLocker lock(&mMutex);
 
-   const auto iter = std::find_if(mCommitsMap.begin(), mCommitsMap.end(),
-                                  [sha](const CommitInfo &commit) { return commit.sha().startsWith(sha); });
+   // The sorted index is updated before the copy so the readers never modify the shared store.
+   mStore.updateSortedIndex();
 
-   if (iter != mCommitsMap.end())
-      return mCommits.indexOf(&iter.value());
+   const auto wipParent = mWip.isValid() ? mStore.indexOf(CommitOid::fromString(mWip.parent(0))) : -1;
+   std::shared_ptr<const Snapshot> snapshot(
+       new Snapshot { mStore, mRows, mWip, wipParent, mReferences, mWipLocalChanges, mGeneration });
 
-   return -1;
+   std::atomic_store(&mSnapshot, std::move(snapshot));
 }
 
-CommitInfo GitCache::getCommitInfoByField(CommitInfo::Field field, const QString &text, int startingPoint, bool reverse)
+void GitCache::updateSearchIndex()
 {
-   QMutexLocker lock(&mMutex);
-   CommitInfo commit;
+   QMutexLocker lock(&mSearchIndexMutex);
 
-   if (!reverse)
+   // Only one build runs at a time. The running one repeats with the last snapshot if it was requested meanwhile. The
+   // display texts of the history view are built by the same worker.
+   if (mSearchIndexRunning)
    {
-      auto commitIter = searchCommit(field, text, startingPoint);
+      mSearchIndexPending = true;
+      return;
+   }
 
-      if (commitIter == mCommits.constEnd())
-         commitIter = searchCommit(field, text);
+   mSearchIndexRunning = true;
+   mSearchIndexFuture = QtConcurrent::run([this]() {
+      forever
+      {
+         buildSearchIndex();
+         buildDisplayData();
 
-      if (commitIter != mCommits.constEnd())
-         commit = **commitIter;
-   }
+         QMutexLocker lock(&mSearchIndexMutex);
+
+         if (!mSearchIndexPending)
+         {
+            mSearchIndexRunning = false;
+            return;
+         }
+
+         mSearchIndexPending = false;
+      }
+   });
+}
+
+void GitCache::buildSearchIndex()
+{
+   const auto snapshot = getSnapshot();
+   const auto current = std::atomic_load(&mSearchIndex);
+
+   // The index of the same store is extended with the new commits, otherwise it's built from scratch.
+   auto index = current && current->generation() == snapshot->generation
+       ? std::make_shared<CommitSearchIndex>(*current)
+       : std::make_shared<CommitSearchIndex>(snapshot->generation);
+
+   index->update(snapshot->store);
+
+   std::atomic_store(&mSearchIndex, std::shared_ptr<const CommitSearchIndex>(std::move(index)));
+
+   QLog_Debug("Git", QString("The search index has been updated with {%1} commits.").arg(snapshot->rows.count() - 1));
+}
+
+void GitCache::buildDisplayData()
+{
+   const auto snapshot = getSnapshot();
+   const auto current = std::atomic_load(&mDisplayData);
+
+   auto displayData = current && current->generation() == snapshot->generation
+       ? std::make_shared<CommitDisplayData>(*current)
+       : std::make_shared<CommitDisplayData>(snapshot->generation);
+
+   displayData->update(snapshot->store, snapshot->rows, snapshot->wip.authorDate().toLongLong());
+
+   std::atomic_store(&mDisplayData, std::shared_ptr<const CommitDisplayData>(std::move(displayData)));
+
+   emit signalDisplayDataUpdated();
+}
+
+QVector<int> GitCache::searchRows(const QString &text) const
+{
+   QVector<int> rows;
+
+   if (text.isEmpty())
+      return rows;
+
+   const auto snapshot = getSnapshot();
+   const auto &store = snapshot->store;
+   const auto index = std::atomic_load(&mSearchIndex);
+   QVector<qint32> candidates;
+
+   if (index && index->generation() == snapshot->generation && text.length() >= CommitSearchIndex::GRAM_LENGTH)
+      candidates = index->candidates(text, store.count());
    else
    {
-      auto commitIter = reverseSearchCommit(field, text, startingPoint);
+      candidates.reserve(store.count());
 
-      if (commitIter == mCommits.crend())
-         commitIter = reverseSearchCommit(field, text);
+      for (auto idx = 0; idx < store.count(); ++idx)
+         candidates.append(idx);
+   }
 
-      if (commitIter != mCommits.crend())
-         commit = **commitIter;
+   // The index gives the commits that have all the trigrams of the text, but they can be in different places.
+   for (auto idx : qAsConst(candidates))
+   {
+      if (store.isLoaded(idx) && store.row(idx) > 0
+          && (store.shortLog(idx).contains(text) || store.longLog(idx).contains(text)
+              || store.author(idx).contains(text)))
+      {
+         rows.append(store.row(idx));
+      }
    }
 
-   return commit;
+   std::sort(rows.begin(), rows.end());
+
+   return rows;
 }
 
-CommitInfo GitCache::getCommitInfo(const QString &sha)
+bool GitCache::hasCommitBodies() const
 {
-   QMutexLocker lock(&mMutex);
+   const auto snapshot = getSnapshot();
+
+   // All the commits are loaded in the same way.
+   return snapshot->rows.count() <= 1 || snapshot->store.isLongLogLoaded(snapshot->rows.at(1));
+}
+
+ResolvedHistoryFilter GitCache::resolveFilter(const Snapshot &snapshot, const HistoryFilter &filter)
+{
+   ResolvedHistoryFilter resolved;
+   resolved.filter = filter;
+   resolved.since = filter.since.isValid() ? filter.since.toSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+   resolved.until = filter.until.isValid() ? filter.until.toSecsSinceEpoch() : std::numeric_limits<qint64>::max();
+
+   if (filter.reference.isEmpty())
+      return resolved;
+
+   const auto &store = snapshot.store;
+   const auto types = { References::Type::LocalBranch, References::Type::RemoteBranches, References::Type::LocalTag,
+                        References::Type::RemoteTag };
+   QVector<qint32> pending;
+
+   for (auto iter = snapshot.references.cbegin(); iter != snapshot.references.cend(); ++iter)
+   {
+      for (auto type : types)
+      {
+         if (iter.value().getReferences(type).contains(filter.reference))
+         {
+            pending.append(iter.key());
+            break;
+         }
+      }
+   }
+
+   if (pending.isEmpty())
+   {
+      resolved.unknownReference = true;
+      return resolved;
+   }
 
-   if (!sha.isEmpty())
+   // The commits reachable from the reference are marked walking the parents. The ones already marked are not
+   // walked again, so every commit is visited once.
+   QBitArray visited(store.count());
+   resolved.reachableRows = QBitArray(snapshot.rows.count());
+
+   while (!pending.isEmpty())
    {
-      const auto c = mCommitsMap.value(sha, CommitInfo());
+      const auto idx = pending.takeLast();
+
+      if (idx < 0 || idx >= store.count() || visited.testBit(idx) || !store.isLoaded(idx))
+         continue;
+
+      visited.setBit(idx);
+
+      if (const auto row = store.row(idx); row > 0 && row < resolved.reachableRows.size())
+         resolved.reachableRows.setBit(row);
+
+      for (auto i = 0; i < store.parentsCount(idx); ++i)
+         pending.append(store.parent(idx, i));
+   }
+
+   return resolved;
+}
+
+QVector<int> GitCache::filterRows(const Snapshot &snapshot, const ResolvedHistoryFilter &filter, int firstRow,
+                                  int lastRow, const std::atomic_bool &canceled)
+{
+   QVector<int> rows;
+
+   if (filter.unknownReference)
+      return rows;
+
+   const auto &store = snapshot.store;
+   const auto &criteria = filter.filter;
+   const auto hasReference = !criteria.reference.isEmpty();
+   const auto hasMessage = !criteria.message.pattern().isEmpty();
 
-      if (!c.isValid())
+   lastRow = qMin(lastRow, snapshot.rows.count());
+
+   // The WIP is not a commit, it's never part of the results.
+   for (auto row = qMax(firstRow, 1); row < lastRow && !canceled; ++row)
+   {
+      const auto idx = snapshot.rows.at(row);
+      const auto date = store.date(idx);
+
+      if (date < filter.since || date > filter.until)
+         continue;
+
+      if (hasReference && (row >= filter.reachableRows.size() || !filter.reachableRows.testBit(row)))
+         continue;
+
+      if ((criteria.signature == HistoryFilter::Signature::Signed && !store.isSigned(idx))
+          || (criteria.signature == HistoryFilter::Signature::Unsigned && store.isSigned(idx)))
       {
-         const auto shas = mCommitsMap.keys();
-         const auto it = std::find_if(shas.cbegin(), shas.cend(),
-                                      [sha](const QString &shaToCompare) { return shaToCompare.startsWith(sha); });
+         continue;
+      }
 
-         if (it != shas.cend())
-            return mCommitsMap.value(*it);
+      if (!criteria.author.isEmpty() && !store.author(idx).contains(criteria.author, Qt::CaseInsensitive))
+         continue;
 
-         return CommitInfo();
+      if (hasMessage && !criteria.message.match(store.shortLog(idx)).hasMatch()
+          && !criteria.message.match(store.longLog(idx)).hasMatch())
+      {
+         continue;
       }
 
-      return c;
+      rows.append(row);
    }
 
-   return CommitInfo();
+   return rows;
 }
 
-RevisionFiles GitCache::getRevisionFile(const QString &sha1, const QString &sha2) const
+CommitInfo GitCache::getCommitInfoByRow(int row)
 {
-   return mRevisionFilesMap.value(qMakePair(sha1, sha2));
+   return getCommitInfoByRow(*getSnapshot(), row);
 }
 
-void GitCache::insertCommitInfo(CommitInfo rev, int orderIdx)
+CommitRow GitCache::getCommitRow(int row) const
 {
-   if (!mConfigured)
+   CommitRow commitRow;
+   auto snapshot = getSnapshot();
+
+   if (row < 0 || row >= snapshot->rows.count())
+      return commitRow;
+
+   if (row == 0)
+   {
+      commitRow.mWip = &snapshot->wip;
+      commitRow.mHasChilds = snapshot->wip.hasChilds();
+   }
+   else
    {
-      rev.setLanes(calculateLanes(rev));
+      const auto idx = snapshot->rows.at(row);
 
-      const auto sha = rev.sha();
+      commitRow.mStore = &snapshot->store;
+      commitRow.mIdx = idx;
+      commitRow.mHasChilds = snapshot->store.hasChilds(idx) || idx == snapshot->wipParent;
 
-      if (sha == mCommitsMap.value(CommitInfo::ZERO_SHA).parent(0))
-         rev.addChildReference(&mCommitsMap[CommitInfo::ZERO_SHA]);
+      if (auto displayData = std::atomic_load(&mDisplayData);
+          displayData && displayData->generation() == snapshot->generation && displayData->contains(idx))
+      {
+         commitRow.mDisplay = displayData.get();
+         commitRow.mDisplayOwner = std::move(displayData);
+      }
 
-      mCommitsMap[sha] = rev;
+      if (const auto references = snapshot->references.constFind(idx); references != snapshot->references.constEnd())
+         commitRow.mReferences = &references.value();
+   }
 
-      mCommits.replace(orderIdx, &mCommitsMap[sha]);
+   commitRow.mOwner = std::move(snapshot);
 
-      if (mTmpChildsStorage.contains(sha))
-      {
-         for (auto &child : mTmpChildsStorage.values(sha))
-            mCommitsMap[sha].addChildReference(child);
+   return commitRow;
+}
 
-         mTmpChildsStorage.remove(sha);
-      }
+int GitCache::getCommitPos(const QString &sha)
+{
+   if (sha.isEmpty())
+      return -1;
+
+   // Only the full SHA of the WIP is its own. A short run of zeros can be the beginning of a commit.
+   if (sha == CommitInfo::ZERO_SHA)
+      return 0;
+
+   const auto snapshot = getSnapshot();
+   auto ambiguous = false;
+   const auto idx = snapshot->store.indexOfPrefix(sha, &ambiguous);
+
+   // Like Git, a short SHA that matches more than one commit is not resolved to any of them.
+   if (ambiguous)
+   {
+      QLog_Warning("Git", QString("The short SHA {%1} matches more than one commit.").arg(sha));
+      return -1;
+   }
+
+   return idx != -1 ? snapshot->store.row(idx) : -1;
+}
+
+QVector<int> GitCache::getCommitRows(const QStringList &shas) const
+{
+   const auto snapshot = getSnapshot();
+   const auto &store = snapshot->store;
+   QVector<int> rows;
+   rows.reserve(shas.count());
+
+   for (const auto &sha : shas)
+   {
+      if (sha == CommitInfo::ZERO_SHA)
+         rows.append(0);
+      else if (const auto idx = store.indexOf(CommitOid::fromString(sha)); idx != -1 && store.row(idx) > 0)
+         rows.append(store.row(idx));
+   }
+
+   std::sort(rows.begin(), rows.end());
+   rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+   return rows;
+}
+
+CommitInfo GitCache::getCommitInfo(const QString &sha)
+{
+   if (sha.isEmpty())
+      return CommitInfo();
+
+   const auto snapshot = getSnapshot();
+
+   if (sha == CommitInfo::ZERO_SHA)
+      return snapshot->wip;
+
+   auto ambiguous = false;
+   const auto idx = snapshot->store.indexOfPrefix(sha, &ambiguous);
+
+   if (ambiguous)
+      QLog_Warning("Git", QString("The short SHA {%1} matches more than one commit.").arg(sha));
+
+   return getCommitInfoByIndex(*snapshot, idx);
+}
+
+RevisionFiles GitCache::getRevisionFile(const QString &sha1, const QString &sha2) const
+{
+   QMutexLocker lock(&mRevisionFilesMutex);
+
+   const auto key = qMakePair(sha1, sha2);
+
+   if (sha1 == CommitInfo::ZERO_SHA)
+      return mWipRevisionFiles.value(key);
+
+   // Reading the entry makes it the most recently used.
+   const auto files = mRevisionFilesCache.object(key);
+
+   if (!files)
+      return RevisionFiles();
+
+   touchRevisionFile(key);
+
+   return *files;
+}
+
+void GitCache::insertCommitInfo(const CommitInfo &rev)
+{
+   if (!mConfigured)
+      addCommitInfo(rev);
+}
+
+void GitCache::addCommitInfo(const CommitInfo &rev)
+{
+   // The lanes are calculated once the commit has its index, that is the id the lanes engine works with.
+   const auto idx = mStore.add(rev, QVector<Lane>());
+
+   if (idx != -1)
+   {
+      mStore.setLanes(idx, calculateLanes(idx));
+      mStore.setRow(idx, mRows.count());
+      mRows.append(idx);
+   }
+}
 
-      const auto parents = mCommitsMap.value(sha).parents();
+CommitInfo GitCache::getCommitInfoByIndex(const Snapshot &snapshot, int idx)
+{
+   auto commit = snapshot.store.commit(idx);
 
-      for (const auto &parent : parents)
-         mTmpChildsStorage.insert(parent, &mCommitsMap[sha]);
+   if (commit.isValid())
+   {
+      // The WIP is not in the store, so the link with its parent is not one of the children stored.
+      if (idx == snapshot.wipParent)
+         commit.setHasChilds(true);
+
+      if (const auto references = snapshot.references.constFind(idx); references != snapshot.references.constEnd())
+         commit.addReferences(references.value());
    }
+
+   return commit;
+}
+
+CommitInfo GitCache::getCommitInfoByRow(const Snapshot &snapshot, int row)
+{
+   if (row == 0)
+      return snapshot.wip;
+
+   return row > 0 && row < snapshot.rows.count() ? getCommitInfoByIndex(snapshot, snapshot.rows.at(row)) : CommitInfo();
 }
 
 void GitCache::insertWipRevision(const QString &parentSha, const QString &diffIndex, const QString &diffIndexCache)
@@ -194,8 +640,9 @@ void GitCache::insertWipRevision(const QString &parentSha, const QString &diffIn
 
    insertRevisionFile(CommitInfo::ZERO_SHA, newParentSha, fakeRevFile);
 
-   const auto log
-       = fakeRevFile.count() == mUntrackedfiles.count() ? QString("No local changes") : QString("Local changes");
+   mWipLocalChanges = fakeRevFile.count() - mUntrackedfiles.count() > 0;
+
+   const auto log = mWipLocalChanges ? QString("Local changes") : QString("No local changes");
 
    QStringList parents;
 
@@ -205,18 +652,13 @@ void GitCache::insertWipRevision(const QString &parentSha, const QString &diffIn
    CommitInfo c(CommitInfo::ZERO_SHA, parents, QChar(), QStringLiteral("-"), QDateTime::currentDateTime(),
                 QStringLiteral("-"), log);
 
-   if (mLanes.isEmpty())
-      mLanes.init(c.sha());
-
-   c.setLanes(calculateLanes(c));
-
-   if (mCommits[0])
-      c.setLanes(mCommits[0]->getLanes());
+   // The lanes of the WIP only depend on its parent. They are calculated apart so the engine of the graph, that could
+   // be in the middle of the history, keeps its state.
+   Lanes wipLanes;
+   wipLanes.init(WIP_ID);
+   c.setLanes(calculateWipLanes(wipLanes, newParentSha));
 
-   const auto sha = c.sha();
-
-   mCommitsMap.insert(sha, std::move(c));
-   mCommits[0] = &mCommitsMap[sha];
+   mWip = std::move(c);
 }
 
 bool GitCache::insertRevisionFile(const QString &sha1, const QString &sha2, const RevisionFiles &file)
@@ -225,80 +667,408 @@ bool GitCache::insertRevisionFile(const QString &sha1, const QString &sha2, cons
    const auto emptyShas = !sha1.isEmpty() && !sha2.isEmpty();
    const auto isWip = sha1 == CommitInfo::ZERO_SHA;
 
-   if ((emptyShas || isWip) && mRevisionFilesMap.value(key) != file)
+   if (!emptyShas && !isWip)
+      return false;
+
+   QMutexLocker lock(&mRevisionFilesMutex);
+
+   if (isWip)
    {
-      QLog_Debug("Git", QString("Adding the revisions files between {%1} and {%2}.").arg(sha1, sha2));
+      if (mWipRevisionFiles.value(key) == file)
+         return false;
 
-      mRevisionFilesMap.insert(key, file);
+      mWipRevisionFiles.insert(key, file);
+   }
+   else
+   {
+      if (const auto files = mRevisionFilesCache.object(key); (files ? *files : RevisionFiles()) == file)
+      {
+         if (files)
+            touchRevisionFile(key);
 
-      return true;
+         return false;
+      }
+
+      const auto cost = file.memoryUsage() + (sha1.capacity() + sha2.capacity()) * static_cast<int>(sizeof(QChar));
+
+      // The cache takes the ownership of the entry and deletes it when it's evicted.
+      if (!mRevisionFilesCache.insert(key, new RevisionFiles(file), cost))
+      {
+         QLog_Warning("Git",
+                      QString("The revisions files between {%1} and {%2} don't fit in the cache.").arg(sha1, sha2));
+         return false;
+      }
+
+      touchRevisionFile(key);
    }
 
-   return false;
+   // The paths of the evicted revisions stay in the table until it's compacted. It's done once the table doubles the
+   // paths that were in use the last time, so the cost is shared by all the insertions.
+   const auto compactionBytes = std::max(mRevisionFilesCache.maxCost() / 2, 2 * mPathTableCompactedBytes);
+
+   if (mPathTable->memoryUsage() > compactionBytes)
+      compactPathTable();
+
+   QLog_Debug("Git", QString("Adding the revisions files between {%1} and {%2}.").arg(sha1, sha2));
+
+   return true;
 }
 
-void GitCache::insertReference(const QString &sha, References::Type type, const QString &reference)
+bool GitCache::insertReference(const QString &sha, References::Type type, const QString &reference)
 {
    QMutexLocker lock(&mMutex);
    QLog_Debug("Git", QString("Adding a new reference with SHA {%1}.").arg(sha));
 
-   if (mCommitsMap.contains(sha))
+   if (const auto idx = mStore.indexOf(CommitOid::fromString(sha)); idx != -1 && mStore.isLoaded(idx))
    {
-      auto &commit = mCommitsMap[sha];
-
-      commit.addReference(type, reference);
-
-      if (!mReferences.contains(&mCommitsMap[sha]))
-         mReferences.append(&mCommitsMap[sha]);
+      mReferences[idx].addReference(type, reference);
+      return true;
    }
+
+   return false;
 }
 
 void GitCache::insertLocalBranchDistances(const QString &name, const LocalBranchDistances &distances)
 {
+   QMutexLocker lock(&mMutex);
+
    mLocalBranchDistances[name] = distances;
 }
 
+bool GitCache::hasLocalBranchDistances(const QString &name)
+{
+   QMutexLocker lock(&mMutex);
+
+   return mLocalBranchDistances.contains(name);
+}
+
+GitCache::LocalBranchDistances GitCache::getLocalBranchDistances(const QString &name)
+{
+   QMutexLocker lock(&mMutex);
+
+   return mLocalBranchDistances.value(name);
+}
+
 void GitCache::updateWipCommit(const QString &parentSha, const QString &diffIndex, const QString &diffIndexCache)
 {
+   QMutexLocker lock(&mMutex);
+
    if (mConfigured)
+   {
       insertWipRevision(parentSha, diffIndex, diffIndexCache);
+      publishSnapshot();
+   }
+}
+
+QVector<QPair<int, int>> GitCache::getDistances(const QVector<QPair<QString, QString>> &pairs,
+                                                const DistancesProgress &progress)
+{
+   // For every pair it returns the commits only reachable from the first SHA and the ones only reachable from the
+   // second. If any of them is not in the graph, the pair is {-1, -1}.
+   QVector<QPair<int, int>> distances(pairs.count(), qMakePair(-1, -1));
+   QHash<QString, int> rows;
+   QVector<int> parentsOffset;
+   QVector<int> parentRows;
+
+   // The shape of the graph is taken from the last snapshot, so the loader isn't blocked while the distances are
+   // counted.
+   {
+      const auto snapshot = getSnapshot();
+      const auto &store = snapshot->store;
+      const auto &graphRows = snapshot->rows;
+
+      for (const auto &pair : pairs)
+      {
+         for (const auto &sha : { pair.first, pair.second })
+         {
+            if (const auto idx = store.indexOf(CommitOid::fromString(sha)); idx != -1 && store.row(idx) != -1)
+               rows.insert(sha, store.row(idx));
+         }
+      }
+
+      parentsOffset.fill(0, graphRows.count() + 1);
+      parentRows.reserve(graphRows.count());
+
+      // The WIP row has no parents in the store, it's not one of the tips that are compared.
+      for (auto i = 1; i < graphRows.count(); ++i)
+      {
+         const auto idx = graphRows.at(i);
+
+         for (auto parent = 0; parent < store.parentsCount(idx); ++parent)
+         {
+            if (const auto parentRow = store.row(store.parent(idx, parent)); parentRow > i)
+               parentRows.append(parentRow);
+         }
+
+         parentsOffset[i + 1] = parentRows.count();
+      }
+   }
+
+   const auto rowsCount = parentsOffset.count() - 1;
+
+   // The graph is sorted topologically, so the reachability can be propagated from the children to the parents in one
+   // pass. Every pass tracks up to 64 tips in the bits of a word and the pairs are evaluated over the histogram of the
+   // different words, that is much smaller than the graph.
+   const auto tipsPerPass = static_cast<int>(sizeof(quint64) * 8);
+   auto pairIdx = 0;
+
+   while (pairIdx < pairs.count())
+   {
+      QHash<int, int> bitsByRow;
+      QVector<int> passPairs;
+
+      for (; pairIdx < pairs.count(); ++pairIdx)
+      {
+         const auto first = rows.value(pairs.at(pairIdx).first, -1);
+         const auto second = rows.value(pairs.at(pairIdx).second, -1);
+
+         if (first == -1 || second == -1)
+            continue;
+
+         const auto newBits = (bitsByRow.contains(first) ? 0 : 1) + (bitsByRow.contains(second) ? 0 : 1);
+
+         if (bitsByRow.count() + newBits > tipsPerPass)
+            break;
+
+         if (!bitsByRow.contains(first))
+            bitsByRow.insert(first, bitsByRow.count());
+
+         if (!bitsByRow.contains(second))
+            bitsByRow.insert(second, bitsByRow.count());
+
+         passPairs.append(pairIdx);
+      }
+
+      // The pairs that are not in the graph are not part of any pass.
+      if (passPairs.isEmpty())
+      {
+         if (progress)
+            progress(pairIdx, distances);
+
+         continue;
+      }
+
+      QVector<quint64> reachable(rowsCount, 0);
+
+      for (auto iter = bitsByRow.cbegin(); iter != bitsByRow.cend(); ++iter)
+         reachable[iter.key()] |= quint64(1) << iter.value();
+
+      QHash<quint64, int> histogram;
+
+      for (auto row = 0; row < rowsCount; ++row)
+      {
+         if (const auto bits = reachable.at(row); bits != 0)
+         {
+            ++histogram[bits];
+
+            for (auto i = parentsOffset.at(row); i < parentsOffset.at(row + 1); ++i)
+               reachable[parentRows.at(i)] |= bits;
+         }
+      }
+
+      for (auto idx : qAsConst(passPairs))
+      {
+         const auto firstBit = quint64(1) << bitsByRow.value(rows.value(pairs.at(idx).first));
+         const auto secondBit = quint64(1) << bitsByRow.value(rows.value(pairs.at(idx).second));
+         auto onlyFirst = 0;
+         auto onlySecond = 0;
+
+         for (auto iter = histogram.cbegin(); iter != histogram.cend(); ++iter)
+         {
+            const auto inFirst = (iter.key() & firstBit) != 0;
+            const auto inSecond = (iter.key() & secondBit) != 0;
+
+            if (inFirst && !inSecond)
+               onlyFirst += iter.value();
+            else if (inSecond && !inFirst)
+               onlySecond += iter.value();
+         }
+
+         distances[idx] = qMakePair(onlyFirst, onlySecond);
+      }
+
+      if (progress)
+         progress(pairIdx, distances);
+   }
+
+   return distances;
 }
 
 bool GitCache::containsRevisionFile(const QString &sha1, const QString &sha2) const
 {
-   return mRevisionFilesMap.contains(qMakePair(sha1, sha2));
+   QMutexLocker lock(&mRevisionFilesMutex);
+
+   const auto key = qMakePair(sha1, sha2);
+
+   return sha1 == CommitInfo::ZERO_SHA ? mWipRevisionFiles.contains(key) : mRevisionFilesCache.contains(key);
+}
+
+void GitCache::setRevisionFilesBudget(int megabytes)
+{
+   QMutexLocker lock(&mRevisionFilesMutex);
+
+   // The cost is an int, so the budget is limited to less than 2 GB.
+   mRevisionFilesCache.setMaxCost(qBound(1, megabytes, 2047) * 1024 * 1024);
 }
 
-QVector<Lane> GitCache::calculateLanes(const CommitInfo &c)
+GitCache::SubgraphLanes GitCache::calculateSubgraphLanes(const Snapshot &snapshot, const QVector<int> &rows,
+                                                         const std::atomic_bool &canceled)
 {
-   const auto sha = c.sha();
+   const auto &store = snapshot.store;
+   QHash<qint32, int> positions;
+   positions.reserve(rows.count());
+
+   for (auto i = 0; i < rows.count(); ++i)
+   {
+      if (rows.at(i) > 0 && rows.at(i) < snapshot.rows.count())
+         positions.insert(snapshot.rows.at(rows.at(i)), i);
+   }
+
+   // The nearest ancestors in the subset of the commits that are not part of it. They are resolved walking the
+   // parents without recursion, since the chains between the commits of the subset can be very long.
+   QHash<qint32, Lanes::Parents> ancestors;
+
+   // The same ancestor can be reached through several parents. The order is kept, so the first parent is still the
+   // one the lane of the commit continues to.
+   const auto appendUnique = [](Lanes::Parents &parents, qint32 id) {
+      if (std::find(parents.constBegin(), parents.constEnd(), id) == parents.constEnd())
+         parents.append(id);
+   };
+
+   // A single walk can go through most of the history, so it stops as soon as the calculation is canceled.
+   const auto resolve = [&store, &positions, &ancestors, &appendUnique, &canceled](qint32 start) {
+      QVector<qint32> pending { start };
+
+      while (!pending.isEmpty() && !canceled)
+      {
+         const auto idx = pending.constLast();
+
+         if (ancestors.contains(idx))
+         {
+            pending.removeLast();
+            continue;
+         }
+
+         auto isReady = true;
+
+         for (auto i = 0; i < store.parentsCount(idx); ++i)
+         {
+            const auto parent = store.parent(idx, i);
+
+            if (store.isLoaded(parent) && !positions.contains(parent) && !ancestors.contains(parent))
+            {
+               pending.append(parent);
+               isReady = false;
+            }
+         }
+
+         if (!isReady)
+            continue;
+
+         Lanes::Parents result;
+
+         for (auto i = 0; i < store.parentsCount(idx); ++i)
+         {
+            const auto parent = store.parent(idx, i);
+
+            if (positions.contains(parent))
+               appendUnique(result, parent);
+            else if (store.isLoaded(parent))
+            {
+               for (auto ancestor : ancestors[parent])
+                  appendUnique(result, ancestor);
+            }
+         }
+
+         ancestors.insert(idx, result);
+         pending.removeLast();
+      }
+   };
+
+   SubgraphLanes subgraph;
+   subgraph.lanes.resize(rows.count());
+   subgraph.hasChilds.fill(false, rows.count());
+
+   Lanes lanes;
+   auto isInitialized = false;
+
+   for (auto i = 0; i < rows.count(); ++i)
+   {
+      if (canceled)
+         return SubgraphLanes();
+
+      const auto row = rows.at(i);
+
+      // The WIP is not part of the store, it's painted on its own.
+      if (row <= 0 || row >= snapshot.rows.count())
+         continue;
+
+      const auto idx = snapshot.rows.at(row);
+      Lanes::Parents parents;
+
+      for (auto j = 0; j < store.parentsCount(idx); ++j)
+      {
+         const auto parent = store.parent(idx, j);
+
+         if (positions.contains(parent))
+            appendUnique(parents, parent);
+         else if (store.isLoaded(parent))
+         {
+            resolve(parent);
+
+            for (auto ancestor : ancestors[parent])
+               appendUnique(parents, ancestor);
+         }
+      }
+
+      for (auto parent : qAsConst(parents))
+         subgraph.hasChilds[positions.value(parent)] = true;
+
+      if (!isInitialized)
+      {
+         lanes.init(idx);
+         isInitialized = true;
+      }
+
+      subgraph.lanes[i] = lanes.calculate(idx, parents);
+   }
 
-   QLog_Trace("Git", QString("Updating the lanes for SHA {%1}.").arg(sha));
+   return subgraph;
+}
 
-   bool isDiscontinuity;
-   bool isFork = mLanes.isFork(sha, isDiscontinuity);
-   bool isMerge = c.parentsCount() > 1;
+QVector<Lane> GitCache::calculateLanes(Lanes &lanes, int idx)
+{
+   Lanes::Parents parents;
 
-   if (isDiscontinuity)
-      mLanes.changeActiveLane(sha); // uses previous isBoundary state
+   for (auto i = 0; i < mStore.parentsCount(idx); ++i)
+      parents.append(mStore.parent(idx, i));
 
-   if (isFork)
-      mLanes.setFork(sha);
-   if (isMerge)
-      mLanes.setMerge(c.parents());
-   if (c.parentsCount() == 0)
-      mLanes.setInitial();
+   return lanes.calculate(idx, parents);
+}
 
-   const auto lanes = mLanes.getLanes();
+QVector<Lane> GitCache::calculateWipLanes(Lanes &lanes, const QString &parentSha)
+{
+   Lanes::Parents parents;
 
-   resetLanes(c, isFork);
+   // The parent gets its index now if it's not loaded yet, the index is kept when it's added.
+   if (const auto oid = CommitOid::fromString(parentSha); oid.isValid())
+      parents.append(mStore.indexFor(oid));
 
-   return lanes;
+   return lanes.calculate(WIP_ID, parents);
 }
 
 RevisionFiles GitCache::parseDiffFormat(const QString &buf, FileNamesLoader &fl, bool)
 {
+   // The table is taken once per loader, so all the revisions it parses have ids of the same table even if it's
+   // compacted meanwhile.
+   if (!fl.paths)
+   {
+      QMutexLocker lock(&mRevisionFilesMutex);
+      fl.paths = mPathTable;
+   }
+
    RevisionFiles rf;
+   rf.setPathTable(fl.paths);
    auto parNum = 1;
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
@@ -364,31 +1134,53 @@ RevisionFiles GitCache::parseDiffFormat(const QString &buf, FileNamesLoader &fl,
 
 void GitCache::appendFileName(const QString &name, FileNamesLoader &fl)
 {
-   int idx = name.lastIndexOf('/') + 1;
-   const QString &dr = name.left(idx);
-   const QString &nm = name.mid(idx);
+   fl.ids.append(fl.paths->intern(name));
+}
 
-   auto it = mDirNames.indexOf(dr);
-   if (it == -1)
-   {
-      int idx = mDirNames.count();
-      mDirNames.append(dr);
-      fl.rfDirs.append(idx);
-   }
-   else
-      fl.rfDirs.append(it);
+void GitCache::compactPathTable()
+{
+   // The revisions already returned keep the old table alive while they are used.
+   const auto paths = QSharedPointer<PathTable>::create();
+
+   for (auto &files : mWipRevisionFiles)
+      files.remapPaths(paths);
 
-   it = mFileNames.indexOf(nm);
-   if (it == -1)
+   // Reading an entry makes it the most recently used, so they are read from the least recently used to the most
+   // recently used one. That way the order of eviction is the same it was.
+   auto keys = mRevisionFilesCache.keys();
+
+   std::sort(keys.begin(), keys.end(), [this](const QPair<QString, QString> &first,
+                                              const QPair<QString, QString> &second) {
+      return mRevisionFilesUses.value(first) < mRevisionFilesUses.value(second);
+   });
+
+   for (const auto &key : qAsConst(keys))
+      mRevisionFilesCache.object(key)->remapPaths(paths);
+
+   QLog_Debug("Git",
+              QString("The paths table has been compacted from {%1} to {%2} bytes.")
+                  .arg(mPathTable->memoryUsage())
+                  .arg(paths->memoryUsage()));
+
+   mPathTable = paths;
+   mPathTableCompactedBytes = paths->memoryUsage();
+}
+
+void GitCache::touchRevisionFile(const QPair<QString, QString> &key) const
+{
+   mRevisionFilesUses[key] = ++mRevisionFilesClock;
+
+   // The uses of the entries evicted by the cache are removed once they are as many as the ones in it.
+   if (mRevisionFilesUses.count() > 2 * mRevisionFilesCache.count())
    {
-      int idx = mFileNames.count();
-      mFileNames.append(nm);
-      fl.rfNames.append(idx);
+      for (auto iter = mRevisionFilesUses.begin(); iter != mRevisionFilesUses.end();)
+      {
+         if (mRevisionFilesCache.contains(iter.key()))
+            ++iter;
+         else
+            iter = mRevisionFilesUses.erase(iter);
+      }
    }
-   else
-      fl.rfNames.append(it);
-
-   fl.files.append(name);
 }
 
 void GitCache::flushFileNames(FileNamesLoader &fl)
@@ -396,43 +1188,28 @@ void GitCache::flushFileNames(FileNamesLoader &fl)
    if (!fl.rf)
       return;
 
-   for (auto i = 0; i < fl.rfNames.count(); ++i)
-   {
-      const auto dirName = mDirNames.at(fl.rfDirs.at(i));
-      const auto fileName = mFileNames.at(fl.rfNames.at(i));
-
-      if (!fl.rf->mFiles.contains(dirName + fileName))
-         fl.rf->mFiles.append(dirName + fileName);
-   }
+   fl.rf->appendFiles(fl.ids);
 
-   fl.rfNames.clear();
-   fl.rfDirs.clear();
+   fl.ids.clear();
    fl.rf = nullptr;
 }
 
 bool GitCache::pendingLocalChanges()
 {
-   QMutexLocker lock(&mMutex);
-   auto localChanges = false;
-
-   const auto commit = mCommitsMap.value(CommitInfo::ZERO_SHA, CommitInfo());
-
-   if (commit.isValid())
-   {
-      const auto rf = getRevisionFile(CommitInfo::ZERO_SHA, commit.parent(0));
-      localChanges = rf.count() - mUntrackedfiles.count() > 0;
-   }
+   // It's read while the history is painted, so it comes from the snapshot and not from the files of the WIP.
+   const auto snapshot = getSnapshot();
 
-   return localChanges;
+   return snapshot->wip.isValid() && snapshot->localChanges;
 }
 
 QVector<QPair<QString, QStringList>> GitCache::getBranches(References::Type type)
 {
-   QMutexLocker lock(&mMutex);
+   const auto snapshot = getSnapshot();
    QVector<QPair<QString, QStringList>> branches;
 
-   for (auto commit : qAsConst(mReferences))
-      branches.append(QPair<QString, QStringList>(commit->sha(), commit->getReferences(type)));
+   for (auto iter = snapshot->references.cbegin(); iter != snapshot->references.cend(); ++iter)
+      branches.append(
+          QPair<QString, QStringList>(snapshot->store.sha(iter.key()), iter.value().getReferences(type)));
 
    return branches;
 }
@@ -443,10 +1220,12 @@ QMap<QString, QString> GitCache::getTags(References::Type tagType) const
 
    if (tagType == References::Type::LocalTag)
    {
-      for (auto commit : mReferences)
+      const auto snapshot = getSnapshot();
+
+      for (auto iter = snapshot->references.cbegin(); iter != snapshot->references.cend(); ++iter)
       {
-         const auto sha = commit->sha();
-         const auto tagNames = commit->getReferences(tagType);
+         const auto sha = snapshot->store.sha(iter.key());
+         const auto tagNames = iter.value().getReferences(tagType);
 
          for (const auto &tag : tagNames)
             tags[tag] = sha;
@@ -516,44 +1295,30 @@ void GitCache::setExtStatus(RevisionFiles &rf, const QString &rowSt, int parNum,
    rf.setOnlyModified(false);
 }
 
-QVector<CommitInfo *>::const_iterator GitCache::searchCommit(CommitInfo::Field field, const QString &text,
-                                                             const int startingPoint) const
-{
-   return std::find_if(mCommits.constBegin() + startingPoint, mCommits.constEnd(),
-                       [field, text](CommitInfo *info) { return info->getFieldStr(field).contains(text); });
-}
-
-QVector<CommitInfo *>::const_reverse_iterator
-GitCache::reverseSearchCommit(CommitInfo::Field field, const QString &text, int startingPoint) const
+void GitCache::clearReferences()
 {
-   const auto startEndPos = startingPoint > 0 ? mCommits.count() - startingPoint + 1 : 0;
-
-   return std::find_if(mCommits.crbegin() + startEndPos, mCommits.crend(),
-                       [field, text](CommitInfo *info) { return info->getFieldStr(field).contains(text); });
-}
-
-void GitCache::resetLanes(const CommitInfo &c, bool isFork)
-{
-   const auto nextSha = c.parentsCount() == 0 ? QString() : c.parent(0);
-
-   mLanes.nextParent(nextSha);
+   QMutexLocker lock(&mMutex);
 
-   if (c.parentsCount() > 1)
-      mLanes.afterMerge();
-   if (isFork)
-      mLanes.afterFork();
-   if (mLanes.isBranch())
-      mLanes.afterBranch();
+   // The distances belong to the branches, so they are calculated again with them.
+   mReferences.clear();
+   mLocalBranchDistances.clear();
 }
 
 int GitCache::count() const
 {
-   return mCommits.count();
+   return getSnapshot()->rows.count();
 }
 
 RevisionFiles GitCache::fakeWorkDirRevFile(const QString &diffIndex, const QString &diffIndexCache)
 {
+   // The files are compared by id, so both parses must intern the paths in the same table.
    FileNamesLoader fl;
+
+   {
+      QMutexLocker lock(&mRevisionFilesMutex);
+      fl.paths = mPathTable;
+   }
+
    auto rf = parseDiffFormat(diffIndex, fl);
    fl.rf = &rf;
    rf.setOnlyModified(false);
@@ -574,9 +1339,16 @@ RevisionFiles GitCache::fakeWorkDirRevFile(const QString &diffIndex, const QStri
    RevisionFiles cachedFiles = parseDiffFormat(diffIndexCache, fl, true);
    flushFileNames(fl);
 
+   // Both revisions use the table taken above, so the files are compared by id.
+   QSet<int> cachedIds;
+   const auto ids = rf.getFileIds();
+
+   for (auto id : cachedFiles.getFileIds())
+      cachedIds.insert(id);
+
    for (auto i = 0; i < rf.count(); i++)
    {
-      if (cachedFiles.mFiles.indexOf(rf.getFile(i)) != -1)
+      if (cachedIds.contains(ids.at(i)))
       {
          if (cachedFiles.statusCmp(i, RevisionFiles::CONFLICT))
             rf.appendStatus(i, RevisionFiles::CONFLICT);
@@ -26,12 +26,24 @@
 #include <RevisionFiles.h>
 #include <lanes.h>
 #include <CommitInfo.h>
+#include <CommitDisplayData.h>
+#include <CommitRow.h>
+#include <CommitSearchIndex.h>
+#include <CommitStore.h>
+#include <GraphRows.h>
+#include <HistoryFilter.h>
 
 #include <QSharedPointer>
 #include <QObject>
+#include <QCache>
+#include <QFuture>
 #include <QHash>
 #include <QMutex>
 
+#include <atomic>
+#include <functional>
+#include <memory>
+
 struct WipRevisionInfo
 {
    QString parentSha;
@@ -47,8 +59,15 @@ class GitCache : public QObject
 
 signals:
    void signalCacheUpdated();
+   /**
+    * @brief Signal triggered from the background worker every time the texts shown in the history are rebuilt.
+    */
+   void signalDisplayDataUpdated();
 
 public:
+   // The memory the files of the revisions can use if it's not configured.
+   static constexpr int DEFAULT_REVISION_FILES_BUDGET_MB = 64;
+
    struct LocalBranchDistances
    {
       int aheadMaster = 0;
@@ -57,26 +76,164 @@ public:
       int behindOrigin = 0;
    };
 
+
+   /**
+    * @brief An immutable copy of the graph. The GUI reads the last one published without locking while the loader
+    * keeps modifying its own copy. Publishing it is cheap because the Qt containers are implicitly shared, but the
+    * next change in the loader's copy detaches every array of the store that it touches, so each snapshot published in
+    * the middle of a load costs a full copy of the store. That's why the loader publishes by batches.
+    */
+   struct Snapshot
+   {
+      CommitStore store;
+      GraphRows rows;
+      CommitInfo wip;
+      // The store index of the parent of the WIP, that is linked with it outside the store.
+      qint32 wipParent = -1;
+      QMap<qint32, References> references;
+      // Whether the WIP has changes other than the untracked files.
+      bool localChanges = false;
+      // Changes every time the store is rebuilt from scratch.
+      quint32 generation = 0;
+   };
+
+   /**
+    * @brief Returns the last snapshot published. The queries that take it see the same graph in all their steps, even
+    * if the loader publishes a new one meanwhile. It can be called from any thread.
+    */
+   std::shared_ptr<const Snapshot> getSnapshot() const { return std::atomic_load(&mSnapshot); }
+
    explicit GitCache(QObject *parent = nullptr);
    ~GitCache();
 
    void setup(const WipRevisionInfo &wipInfo, const QList<CommitInfo> &commits);
+   /**
+    * @brief Configures the cache with a graph that was already calculated, keeping its lanes. The WIP and the commits
+    * that are not in the graph yet are added with @ref prependCommits before the snapshot is published.
+    *
+    * @param store The store with the commits and their lanes.
+    * @param rows The rows of the graph.
+    * @param lanesHeadSha The HEAD the lanes were calculated with.
+    */
+   void setup(const CommitStore &store, const GraphRows &rows, const QString &lanesHeadSha);
+   void appendCommits(const QList<CommitInfo> &commits);
+   void appendPage(const QList<CommitInfo> &commits);
+   /**
+    * @brief Adds the new commits on top of the graph and updates the WIP. The lanes of the rows below are only
+    * calculated again until they are the same they were. The snapshot is not published, so the references can be
+    * updated before the GUI sees the new rows.
+    *
+    * @param wipInfo The WIP, that is a child of the new HEAD.
+    * @param commits The new commits, in the order they are shown.
+    */
+   void prependCommits(const WipRevisionInfo &wipInfo, const QList<CommitInfo> &commits);
 
    int count() const;
 
    CommitInfo getCommitInfo(const QString &sha);
    CommitInfo getCommitInfoByRow(int row);
+   /**
+    * @brief Returns a read-only handle to a row of the graph. Unlike @ref getCommitInfoByRow it doesn't copy the
+    * commit, so it's the one to use while painting.
+    *
+    * @param row The row in the graph.
+    * @return CommitRow The handle, not valid if the row is out of range.
+    */
+   CommitRow getCommitRow(int row) const;
    int getCommitPos(const QString &sha);
-   CommitInfo getCommitInfoByField(CommitInfo::Field field, const QString &text, int startingPoint, bool reverse);
+   /**
+    * @brief Returns the rows of a list of commits at once.
+    *
+    * @param shas The full SHAs of the commits.
+    * @return QVector<int> The rows, sorted and without duplicates. The commits that are not in the graph are skipped.
+    */
+   QVector<int> getCommitRows(const QStringList &shas) const;
+   /**
+    * @brief Returns all the rows which short log, long log or author contain the text. It uses the search index built
+    * in the background once the history is loaded.
+    *
+    * @param text The text to search.
+    * @return QVector<int> The rows of the commits found, sorted.
+    */
+   QVector<int> searchRows(const QString &text) const;
+   /**
+    * @brief Whether the commits were loaded with their bodies. Without them, the searches and the filters only match
+    * the subjects.
+    */
+   bool hasCommitBodies() const;
+   /**
+    * @brief Resolves the criteria of the filter that depend on the graph. The result can be shared by the threads
+    * that call @ref filterRows with the same snapshot. It walks the graph, so it's called from a worker thread.
+    *
+    * @param snapshot The graph the filter is evaluated on.
+    * @param filter The filter.
+    * @return ResolvedHistoryFilter The filter ready to be evaluated.
+    */
+   static ResolvedHistoryFilter resolveFilter(const Snapshot &snapshot, const HistoryFilter &filter);
+   /**
+    * @brief Returns the rows in the range that match the filter. It can be called from any thread.
+    *
+    * @param snapshot The graph the filter was resolved on.
+    * @param filter The filter returned by @ref resolveFilter.
+    * @param firstRow The first row to check.
+    * @param lastRow The row after the last one to check.
+    * @param canceled Flag that stops the evaluation when it's set.
+    * @return QVector<int> The rows that match, sorted.
+    */
+   static QVector<int> filterRows(const Snapshot &snapshot, const ResolvedHistoryFilter &filter, int firstRow,
+                                  int lastRow, const std::atomic_bool &canceled);
    RevisionFiles getRevisionFile(const QString &sha1, const QString &sha2) const;
 
    bool insertRevisionFile(const QString &sha1, const QString &sha2, const RevisionFiles &file);
-   void insertReference(const QString &sha, References::Type type, const QString &reference);
+   /**
+    * @brief Adds a reference to a commit of the graph.
+    *
+    * @return True if the commit is loaded, otherwise the reference is not added.
+    */
+   bool insertReference(const QString &sha, References::Type type, const QString &reference);
    void insertLocalBranchDistances(const QString &name, const LocalBranchDistances &distances);
-   LocalBranchDistances getLocalBranchDistances(const QString &name) { return mLocalBranchDistances.value(name); }
+   /**
+    * @brief Called by @ref getDistances every time the distances of some pairs are ready.
+    *
+    * @param pairsDone The pairs before this one are calculated.
+    * @param distances The distances of all the pairs. The ones not calculated yet are {-1, -1}.
+    */
+   using DistancesProgress = std::function<void(int pairsDone, const QVector<QPair<int, int>> &distances)>;
+   QVector<QPair<int, int>> getDistances(const QVector<QPair<QString, QString>> &pairs,
+                                         const DistancesProgress &progress = DistancesProgress());
+   bool hasLocalBranchDistances(const QString &name);
+   LocalBranchDistances getLocalBranchDistances(const QString &name);
    void updateWipCommit(const QString &parentSha, const QString &diffIndex, const QString &diffIndexCache);
 
    bool containsRevisionFile(const QString &sha1, const QString &sha2) const;
+   /**
+    * @brief Sets the memory the files of the revisions can use. The least recently used are evicted when it's
+    * exceeded. The files of the WIP are not evicted.
+    *
+    * @param megabytes The budget in megabytes.
+    */
+   void setRevisionFilesBudget(int megabytes);
+
+   /**
+    * @brief The lanes of a subset of the rows of the graph.
+    */
+   struct SubgraphLanes
+   {
+      QVector<QVector<Lane>> lanes;
+      QVector<bool> hasChilds;
+   };
+   /**
+    * @brief Calculates the lanes of a subset of the rows as if they were the whole graph. The parents of every commit
+    * are replaced by its nearest ancestors in the subset, so the lines join the commits shown. It can be called from
+    * any thread.
+    *
+    * @param snapshot The graph the rows belong to.
+    * @param rows The rows of the subset, sorted.
+    * @param canceled Flag that stops the calculation when it's set.
+    * @return SubgraphLanes The lanes of every row of the subset, or empty if it was canceled.
+    */
+   static SubgraphLanes calculateSubgraphLanes(const Snapshot &snapshot, const QVector<int> &rows,
+                                               const std::atomic_bool &canceled);
 
    RevisionFiles parseDiff(const QString &logDiff);
 
@@ -91,17 +248,34 @@ public:
 private:
    friend class GitRepoLoader;
 
-   QMutex mMutex;
+   mutable QMutex mMutex;
    bool mConfigured = true;
-   QVector<CommitInfo *> mCommits;
-   QHash<QString, CommitInfo> mCommitsMap;
-   QMultiMap<QString, CommitInfo *> mTmpChildsStorage;
-   QHash<QPair<QString, QString>, RevisionFiles> mRevisionFilesMap;
-   QVector<CommitInfo *> mReferences;
+   std::shared_ptr<const Snapshot> mSnapshot = std::make_shared<const Snapshot>();
+   quint32 mGeneration = 0;
+   std::shared_ptr<const CommitSearchIndex> mSearchIndex;
+   std::shared_ptr<const CommitDisplayData> mDisplayData;
+   QMutex mSearchIndexMutex;
+   QFuture<void> mSearchIndexFuture;
+   bool mSearchIndexRunning = false;
+   bool mSearchIndexPending = false;
+   CommitStore mStore;
+   GraphRows mRows;
+   CommitInfo mWip;
+   bool mWipLocalChanges = false;
+   // The files of the commits are evicted when they exceed the budget. The ones of the WIP are always kept. They have
+   // their own lock since the GUI reads them while the loader holds the one of the graph.
+   mutable QMutex mRevisionFilesMutex;
+   QCache<QPair<QString, QString>, RevisionFiles> mRevisionFilesCache;
+   // When every entry of the cache was used for the last time, since the cache doesn't give its order of eviction.
+   mutable QHash<QPair<QString, QString>, quint64> mRevisionFilesUses;
+   mutable quint64 mRevisionFilesClock = 0;
+   QHash<QPair<QString, QString>, RevisionFiles> mWipRevisionFiles;
+   QMap<qint32, References> mReferences;
    QMap<QString, LocalBranchDistances> mLocalBranchDistances;
    Lanes mLanes;
-   QVector<QString> mDirNames;
-   QVector<QString> mFileNames;
+   QString mLanesHeadSha;
+   QSharedPointer<PathTable> mPathTable = QSharedPointer<PathTable>::create();
+   int mPathTableCompactedBytes = 0;
    QVector<QString> mUntrackedfiles;
    QMap<QString, QString> mRemoteTags;
 
@@ -113,23 +287,30 @@ private:
       }
 
       RevisionFiles *rf;
-      QVector<int> rfDirs;
-      QVector<int> rfNames;
-      QVector<QString> files;
+      QVector<int> ids;
+      QSharedPointer<PathTable> paths;
    };
 
-   void setConfigurationDone() { mConfigured = true; }
-   void insertCommitInfo(CommitInfo rev, int orderIdx);
+   void reset();
+   void setConfigurationDone();
+   void publishSnapshot();
+   void updateSearchIndex();
+   void buildSearchIndex();
+   void buildDisplayData();
+   void insertCommitInfo(const CommitInfo &rev);
+   void addCommitInfo(const CommitInfo &rev);
+   static CommitInfo getCommitInfoByIndex(const Snapshot &snapshot, int idx);
+   static CommitInfo getCommitInfoByRow(const Snapshot &snapshot, int row);
    void insertWipRevision(const QString &parentSha, const QString &diffIndex, const QString &diffIndexCache);
    RevisionFiles fakeWorkDirRevFile(const QString &diffIndex, const QString &diffIndexCache);
-   QVector<Lane> calculateLanes(const CommitInfo &c);
+   QVector<Lane> calculateLanes(int idx) { return calculateLanes(mLanes, idx); }
+   QVector<Lane> calculateLanes(Lanes &lanes, int idx);
+   QVector<Lane> calculateWipLanes(Lanes &lanes, const QString &parentSha);
    RevisionFiles parseDiffFormat(const QString &buf, FileNamesLoader &fl, bool cached = false);
    void appendFileName(const QString &name, FileNamesLoader &fl);
    void flushFileNames(FileNamesLoader &fl);
+   void compactPathTable();
+   void touchRevisionFile(const QPair<QString, QString> &key) const;
    void setExtStatus(RevisionFiles &rf, const QString &rowSt, int parNum, FileNamesLoader &fl);
-   QVector<CommitInfo *>::const_iterator searchCommit(CommitInfo::Field field, const QString &text,
-                                                      int startingPoint = 0) const;
-   QVector<CommitInfo *>::const_reverse_iterator reverseSearchCommit(CommitInfo::Field field, const QString &text,
-                                                                     int startingPoint = 0) const;
-   void resetLanes(const CommitInfo &c, bool isFork);
+   void clearReferences();
 };
@@ -0,0 +1,78 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QVector>
+
+/**
+ * @brief The GraphRows class keeps the store index of the commit in every row of the graph. The first row is the WIP,
+ * that is not in the store.
+ *
+ * The rows added on top of the graph are kept in reverse order apart from the rest, so adding them doesn't move the
+ * rows that were already there.
+ *
+ * @class GraphRows GraphRows.h "GraphRows.h"
+ */
+class GraphRows
+{
+public:
+   int count() const { return mTop.count() + mBottom.count(); }
+   bool isEmpty() const { return mBottom.isEmpty(); }
+   /**
+    * @brief The store index of the commit in a row, or -1 for the WIP.
+    */
+   qint32 at(int row) const
+   {
+      if (row == 0)
+         return mBottom.at(0);
+
+      return row <= mTop.count() ? mTop.at(mTop.count() - row) : mBottom.at(row - mTop.count());
+   }
+
+   void clear()
+   {
+      mTop.clear();
+      mBottom.clear();
+   }
+   void reserve(int size) { mBottom.reserve(size - mTop.count()); }
+   void append(qint32 idx) { mBottom.append(idx); }
+   /**
+    * @brief Inserts rows below the first one, that is the WIP.
+    *
+    * @param rows The store indices of the rows, in the order they are shown.
+    */
+   void prepend(const QVector<qint32> &rows)
+   {
+      mTop.reserve(mTop.count() + rows.count());
+
+      for (auto i = rows.count() - 1; i >= 0; --i)
+         mTop.append(rows.at(i));
+   }
+
+private:
+   // The rows prepended, the last one is the second row of the graph.
+   QVector<qint32> mTop;
+   // The first row and the rows below the ones prepended.
+   QVector<qint32> mBottom;
+};
@@ -0,0 +1,58 @@
+#include "HistoryFilter.h"
+
+#include <QStringList>
+
+bool HistoryFilter::isEmpty() const
+{
+   return author.isEmpty() && !since.isValid() && !until.isValid() && message.pattern().isEmpty()
+       && signature == Signature::Any && reference.isEmpty();
+}
+
+HistoryFilter HistoryFilter::fromQuery(const QString &query)
+{
+   static const QRegularExpression criterion(R"((\w+):(?:"([^"]*)"|(\S+)))");
+
+   HistoryFilter filter;
+   QStringList words;
+   auto last = 0;
+   auto iter = criterion.globalMatch(query);
+
+   while (iter.hasNext())
+   {
+      const auto match = iter.next();
+      const auto key = match.captured(1).toLower();
+      const auto value = match.captured(2).isEmpty() ? match.captured(3) : match.captured(2);
+      const auto date = QDate::fromString(value, Qt::ISODate);
+
+      words.append(query.mid(last, match.capturedStart() - last));
+      last = match.capturedEnd();
+
+      if (key == QStringLiteral("author"))
+         filter.author = value;
+      else if (key == QStringLiteral("since") && date.isValid())
+         filter.since = QDateTime(date, QTime(0, 0));
+      else if (key == QStringLiteral("until") && date.isValid())
+         filter.until = QDateTime(date, QTime(23, 59, 59));
+      else if (key == QStringLiteral("message"))
+         filter.message = QRegularExpression(value, QRegularExpression::CaseInsensitiveOption);
+      else if (key == QStringLiteral("signed"))
+         filter.signature = value == QStringLiteral("no") ? Signature::Unsigned : Signature::Signed;
+      else if (key == QStringLiteral("ref"))
+         filter.reference = value;
+      else
+         words.append(match.captured(0));
+   }
+
+   // Without any criteria the query is a plain search, not a filter.
+   if (filter.isEmpty())
+      return filter;
+
+   words.append(query.mid(last));
+
+   const auto text = words.join(QStringLiteral(" ")).simplified();
+
+   if (!text.isEmpty() && filter.message.pattern().isEmpty())
+      filter.message = QRegularExpression(QRegularExpression::escape(text), QRegularExpression::CaseInsensitiveOption);
+
+   return filter;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QBitArray>
+#include <QDateTime>
+#include <QRegularExpression>
+#include <QString>
+
+/**
+ * @brief The HistoryFilter struct holds the criteria to filter the commits of the history. A commit is accepted when
+ * it matches all the criteria that are set.
+ *
+ * @struct HistoryFilter HistoryFilter.h "HistoryFilter.h"
+ */
+struct HistoryFilter
+{
+   enum class Signature
+   {
+      Any,
+      Signed,
+      Unsigned
+   };
+
+   /**
+    * @brief Text the author must contain. The comparison is case insensitive.
+    */
+   QString author;
+   /**
+    * @brief The first and last author dates accepted. Invalid dates don't limit the range.
+    */
+   QDateTime since;
+   QDateTime until;
+   /**
+    * @brief Expression the short or long log must match.
+    */
+   QRegularExpression message;
+   Signature signature = Signature::Any;
+   /**
+    * @brief Branch or tag the commits must be reachable from.
+    */
+   QString reference;
+
+   bool isEmpty() const;
+
+   /**
+    * @brief Builds a filter from a query with the form <tt>author:john since:2020-01-31 message:"fix.*crash"</tt>.
+    * The keys are author, since, until, message, signed (yes or no) and ref. The text outside the keys is searched in
+    * the log messages when the query has no message key.
+    *
+    * @param query The text of the query.
+    * @return HistoryFilter The filter. It's empty if the query has no criteria.
+    */
+   static HistoryFilter fromQuery(const QString &query);
+};
+
+/**
+ * @brief The criteria of a @ref HistoryFilter resolved against the graph, so the commits can be checked in parallel
+ * without resolving them again for every commit.
+ *
+ * @struct ResolvedHistoryFilter HistoryFilter.h "HistoryFilter.h"
+ */
+struct ResolvedHistoryFilter
+{
+   HistoryFilter filter;
+   qint64 since = 0;
+   qint64 until = 0;
+   /**
+    * @brief The rows reachable from the reference of the filter. Empty if the filter has no reference.
+    */
+   QBitArray reachableRows;
+   /**
+    * @brief The reference of the filter doesn't exist, so no commit matches.
+    */
+   bool unknownReference = false;
+};
@@ -23,6 +23,8 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <QVarLengthArray>
+
 enum class LaneType;
 
 class Lane
@@ -47,3 +49,8 @@ public:
 private:
    LaneType mType;
 };
+
+/**
+ * @brief The lanes of a row of the graph. The usual graph widths fit in the stack.
+ */
+using LaneRow = QVarLengthArray<Lane, 64>;
@@ -0,0 +1,44 @@
+#include "PathTable.h"
+
+int PathTable::intern(const QString &path)
+{
+   if (const auto id = find(path); id != -1)
+      return id;
+
+   QWriteLocker lock(&mLock);
+
+   // Other thread could have added it between the two locks.
+   if (const auto iter = mIds.constFind(path); iter != mIds.constEnd())
+      return iter.value();
+
+   const auto id = mPaths.count();
+
+   mPaths.append(path);
+   mIds.insert(path, id);
+
+   // The vector and the hash share the data of the path.
+   mBytes += 2 * static_cast<int>(sizeof(QString) + sizeof(int)) + path.capacity() * static_cast<int>(sizeof(QChar));
+
+   return id;
+}
+
+int PathTable::find(const QString &path) const
+{
+   QReadLocker lock(&mLock);
+
+   return mIds.value(path, -1);
+}
+
+QString PathTable::path(int id) const
+{
+   QReadLocker lock(&mLock);
+
+   return mPaths.at(id);
+}
+
+int PathTable::memoryUsage() const
+{
+   QReadLocker lock(&mLock);
+
+   return mBytes;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The PathTable class interns the paths of the files that appear in the diffs. Every path is stored once and
+ * identified by an integer id, so the @ref RevisionFiles keep ids instead of strings. The lookups are hashed.
+ *
+ * The ids are never reused, so a table can be shared between threads and by all the revisions parsed by a cache. The
+ * paths are never removed either: to release the ones no longer used, the revisions are moved to a new table.
+ *
+ * @class PathTable PathTable.h "PathTable.h"
+ */
+class PathTable
+{
+public:
+   /**
+    * @brief Returns the id of a path, adding it to the table if it's not there yet.
+    *
+    * @param path The path of the file.
+    * @return int The id.
+    */
+   int intern(const QString &path);
+   /**
+    * @brief Returns the id of a path without adding it.
+    *
+    * @param path The path of the file.
+    * @return int The id, or -1 if the path is not in the table.
+    */
+   int find(const QString &path) const;
+   /**
+    * @brief Returns the path that has the given id.
+    */
+   QString path(int id) const;
+   /**
+    * @brief Estimates the memory used by the table.
+    *
+    * @return int The size in bytes.
+    */
+   int memoryUsage() const;
+
+private:
+   mutable QReadWriteLock mLock;
+   QVector<QString> mPaths;
+   QHash<QString, int> mIds;
+   int mBytes = 0;
+};
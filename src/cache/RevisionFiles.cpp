@@ -1,8 +1,14 @@
 #include "RevisionFiles.h"
 
+#include <QSet>
+
 bool RevisionFiles::operator==(const RevisionFiles &revFiles) const
 {
-   return mFiles == revFiles.mFiles && mOnlyModified == revFiles.mOnlyModified && mergeParent == revFiles.mergeParent
+   // The ids are only comparable if both revisions use the same table.
+   const auto sameFiles
+       = mPaths == revFiles.mPaths ? mFileIds == revFiles.mFileIds : getFiles() == revFiles.getFiles();
+
+   return sameFiles && mOnlyModified == revFiles.mOnlyModified && mergeParent == revFiles.mergeParent
        && mFileStatus == revFiles.mFileStatus && mRenamedFiles == revFiles.mRenamedFiles;
 }
 
@@ -85,3 +91,69 @@ void RevisionFiles::appendStatus(int pos, RevisionFiles::StatusFlag flag)
 {
    mFileStatus[pos] |= flag;
 }
+
+QStringList RevisionFiles::getFiles() const
+{
+   QStringList files;
+   files.reserve(mFileIds.count());
+
+   for (auto id : mFileIds)
+      files.append(mPaths->path(id));
+
+   return files;
+}
+
+int RevisionFiles::indexOf(const QString &fileName) const
+{
+   const auto id = mPaths ? mPaths->find(fileName) : -1;
+
+   return id != -1 ? mFileIds.indexOf(id) : -1;
+}
+
+void RevisionFiles::appendFiles(const QVector<int> &ids)
+{
+   QSet<int> knownIds;
+   knownIds.reserve(mFileIds.count() + ids.count());
+
+   for (auto id : qAsConst(mFileIds))
+      knownIds.insert(id);
+
+   mFileIds.reserve(mFileIds.count() + ids.count());
+
+   for (auto id : ids)
+   {
+      if (!knownIds.contains(id))
+      {
+         knownIds.insert(id);
+         mFileIds.append(id);
+      }
+   }
+}
+
+void RevisionFiles::remapPaths(const QSharedPointer<PathTable> &paths)
+{
+   if (mPaths == paths)
+      return;
+
+   if (mPaths)
+   {
+      for (auto &id : mFileIds)
+         id = paths->intern(mPaths->path(id));
+   }
+
+   mPaths = paths;
+}
+
+int RevisionFiles::memoryUsage() const
+{
+   auto bytes = static_cast<int>(sizeof(RevisionFiles));
+   bytes += (mergeParent.capacity() + mFileIds.capacity() + mFileStatus.capacity()) * static_cast<int>(sizeof(int));
+
+   for (auto id : mFileIds)
+      bytes += static_cast<int>(sizeof(QString)) + mPaths->path(id).capacity() * static_cast<int>(sizeof(QChar));
+
+   for (const auto &file : mRenamedFiles)
+      bytes += static_cast<int>(sizeof(QString)) + file.capacity() * static_cast<int>(sizeof(QChar));
+
+   return bytes;
+}
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <PathTable.h>
+
 #include <QByteArray>
+#include <QSharedPointer>
 #include <QVector>
 #include <QStringList>
 
@@ -25,10 +28,9 @@ public:
    bool operator!=(const RevisionFiles &revFiles) const;
 
    QVector<int> mergeParent;
-   QVector<QString> mFiles;
 
    // helper functions
-   int count() const { return mFiles.count(); }
+   int count() const { return mFileIds.count(); }
    bool statusCmp(int idx, StatusFlag sf) const;
    const QString extendedStatus(int idx) const;
    void setStatus(const QString &rowSt, bool isStaged = false);
@@ -39,9 +41,34 @@ public:
    void setOnlyModified(bool onlyModified) { mOnlyModified = onlyModified; }
    int getFilesCount() const { return mFileStatus.size(); }
    void appendExtStatus(const QString &file) { mRenamedFiles.append(file); }
-   QString getFile(int index) const { return mFiles.at(index); }
-   QStringList getFiles() const { return mFiles.toList(); }
-   bool containsFile(const QString &fileName) { return mFiles.contains(fileName); }
+   QString getFile(int index) const { return mPaths->path(mFileIds.at(index)); }
+   QStringList getFiles() const;
+   QVector<int> getFileIds() const { return mFileIds; }
+   int indexOf(const QString &fileName) const;
+   bool containsFile(const QString &fileName) const { return indexOf(fileName) != -1; }
+   /**
+    * @brief Sets the table where the paths of the files are interned. It must be set before adding files.
+    */
+   void setPathTable(const QSharedPointer<PathTable> &paths) { mPaths = paths; }
+   /**
+    * @brief Moves the files to another path table, interning their paths in it.
+    *
+    * @param paths The new table.
+    */
+   void remapPaths(const QSharedPointer<PathTable> &paths);
+   /**
+    * @brief Appends the files that are not in the revision yet.
+    *
+    * @param ids The ids of the paths in the path table.
+    */
+   void appendFiles(const QVector<int> &ids);
+   /**
+    * @brief Estimates the memory used by the revision. The paths are included although they are shared in the path
+    * table, so it's an upper bound.
+    *
+    * @return int The size in bytes.
+    */
+   int memoryUsage() const;
 
 private:
    // Status information is splitted in a flags vector and in a string
@@ -55,6 +82,8 @@ private:
    // When status of all the files is 'modified' then onlyModified is
    // set, this let us to do some optimization in this common case
    bool mOnlyModified = true;
+   QSharedPointer<PathTable> mPaths;
+   QVector<int> mFileIds;
    QVector<int> mFileStatus;
    QVector<QString> mRenamedFiles;
 };
@@ -8,40 +8,43 @@
 */
 #include "lanes.h"
 
-#include <QStringList>
-
-void Lanes::init(const QString &expectedSha)
+void Lanes::init(qint32 expectedId)
 {
    clear();
    activeLane = 0;
-   add(LaneType::BRANCH, expectedSha, activeLane);
+   add(LaneType::BRANCH, expectedId, activeLane);
+}
+
+bool Lanes::operator==(const Lanes &lanes) const
+{
+   return activeLane == lanes.activeLane && typeVec == lanes.typeVec && nextIdVec == lanes.nextIdVec;
 }
 
 void Lanes::clear()
 {
    typeVec.clear();
-   nextShaVec.clear();
+   nextIdVec.clear();
 }
 
-bool Lanes::isFork(const QString &sha, bool &isDiscontinuity)
+bool Lanes::isFork(qint32 id, bool &isDiscontinuity)
 {
-   int pos = findNextSha(sha, 0);
+   int pos = findNextId(id, 0);
    isDiscontinuity = activeLane != pos;
 
-   return pos == -1 ? false : findNextSha(sha, pos + 1) != -1;
+   return pos == -1 ? false : findNextId(id, pos + 1) != -1;
 }
 
-void Lanes::setFork(const QString &sha)
+void Lanes::setFork(qint32 id)
 {
    auto rangeEnd = 0;
    auto idx = 0;
-   auto rangeStart = rangeEnd = idx = findNextSha(sha, 0);
+   auto rangeStart = rangeEnd = idx = findNextId(id, 0);
 
    while (idx != -1)
    {
       rangeEnd = idx;
       typeVec[idx].setType(LaneType::TAIL);
-      idx = findNextSha(sha, idx + 1);
+      idx = findNextId(id, idx + 1);
    }
 
    typeVec[activeLane].setType(NODE);
@@ -77,7 +80,7 @@ void Lanes::setFork(const QString &sha)
    }
 }
 
-void Lanes::setMerge(const QStringList &parents)
+void Lanes::setMerge(const Parents &parents)
 {
    auto &t = typeVec[activeLane];
    auto wasFork = t.equals(NODE);
@@ -90,11 +93,11 @@ void Lanes::setMerge(const QStringList &parents)
 
    auto rangeStart = activeLane;
    auto rangeEnd = activeLane;
-   QStringList::const_iterator it(parents.constBegin());
+   auto it = parents.constBegin();
 
    for (++it; it != parents.constEnd(); ++it)
    { // skip first parent
-      int idx = findNextSha(*it, 0);
+      int idx = findNextId(*it, 0);
 
       if (idx != -1)
       {
@@ -158,7 +161,7 @@ void Lanes::setInitial()
       t.setType(LaneType::INITIAL);
 }
 
-void Lanes::changeActiveLane(const QString &sha)
+void Lanes::changeActiveLane(qint32 id)
 {
    auto &t = typeVec[activeLane];
 
@@ -167,11 +170,11 @@ void Lanes::changeActiveLane(const QString &sha)
    else
       t.setType(LaneType::NOT_ACTIVE);
 
-   int idx = findNextSha(sha, 0); // find first sha
+   int idx = findNextId(id, 0); // find first id
    if (idx != -1)
       typeVec[idx].setType(LaneType::ACTIVE); // called before setBoundary()
    else
-      idx = add(LaneType::BRANCH, sha, activeLane); // new branch
+      idx = add(LaneType::BRANCH, id, activeLane); // new branch
 
    activeLane = idx;
 }
@@ -209,7 +212,7 @@ void Lanes::afterFork()
    while (typeVec.last().equals(LaneType::EMPTY))
    {
       typeVec.pop_back();
-      nextShaVec.pop_back();
+      nextIdVec.pop_back();
    }
 }
 
@@ -223,16 +226,19 @@ void Lanes::afterBranch()
    typeVec[activeLane].setType(LaneType::ACTIVE); // TODO test with boundaries
 }
 
-void Lanes::nextParent(const QString &sha)
+void Lanes::nextParent(qint32 id)
 {
-   nextShaVec[activeLane] = sha;
+   nextIdVec[activeLane] = id;
 }
 
-int Lanes::findNextSha(const QString &next, int pos)
+int Lanes::findNextId(qint32 next, int pos) const
 {
-   for (int i = pos; i < nextShaVec.count(); i++)
+   const auto ids = nextIdVec.constData();
+   const auto count = nextIdVec.count();
+
+   for (int i = pos; i < count; i++)
    {
-      if (nextShaVec[i] == next)
+      if (ids[i] == next)
          return i;
    }
 
@@ -252,7 +258,7 @@ int Lanes::findType(const LaneType type, int pos)
    return -1;
 }
 
-int Lanes::add(const LaneType type, const QString &next, int pos)
+int Lanes::add(const LaneType type, qint32 next, int pos)
 {
    // first check empty lanes starting from pos
    if (pos < typeVec.count())
@@ -261,14 +267,14 @@ int Lanes::add(const LaneType type, const QString &next, int pos)
       if (pos != -1)
       {
          typeVec[pos].setType(type);
-         nextShaVec[pos] = next;
+         nextIdVec[pos] = next;
          return pos;
       }
    }
 
    // if all lanes are occupied add a new lane
    typeVec.append(type);
-   nextShaVec.append(next);
+   nextIdVec.append(next);
    return typeVec.count() - 1;
 }
 
@@ -276,3 +282,37 @@ bool Lanes::isNode(Lane lane) const
 {
    return lane.equals(NODE) || lane.equals(NODE_R) || lane.equals(NODE_L);
 }
+
+QVector<Lane> Lanes::calculate(qint32 id, const Parents &parents)
+{
+   bool isDiscontinuity;
+   const auto fork = isFork(id, isDiscontinuity);
+
+   if (isDiscontinuity)
+      changeActiveLane(id); // uses previous isBoundary state
+
+   if (fork)
+      setFork(id);
+   if (parents.count() > 1)
+      setMerge(parents);
+   if (parents.isEmpty())
+      setInitial();
+
+   const auto lanes = typeVec;
+
+   reset(parents, fork);
+
+   return lanes;
+}
+
+void Lanes::reset(const Parents &parents, bool isFork)
+{
+   nextParent(parents.isEmpty() ? NO_COMMIT : parents.first());
+
+   if (parents.count() > 1)
+      afterMerge();
+   if (isFork)
+      afterFork();
+   if (isBranch())
+      afterBranch();
+}
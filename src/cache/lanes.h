@@ -7,7 +7,7 @@
 #ifndef LANES_H
 #define LANES_H
 
-#include <QString>
+#include <QVarLengthArray>
 #include <QVector>
 
 #include <LaneType.h>
@@ -15,7 +15,8 @@
 
 //
 //  At any given time, the Lanes class represents a single revision (row) of the history graph.
-//  The Lanes class contains a vector of the sha1 hashes of the next commit to appear in each lane (column).
+//  The Lanes class contains a vector of the ids of the next commit to appear in each lane (column). The ids are
+//  assigned by the caller (the index of the commit in the cache) so matching a lane is an integer comparison.
 //  The Lanes class also contains a vector used to decide which glyph to draw on the history graph.
 //
 //  For each revision (row) (from recent (top) to ancient past (bottom)), the Lanes class is updated, and the
@@ -27,32 +28,41 @@
 class Lanes
 {
 public:
+   // The id used as next commit of the lanes that don't continue.
+   static constexpr qint32 NO_COMMIT = -1;
+   using Parents = QVarLengthArray<qint32, 8>;
+
    Lanes() { } // init() will setup us later, when data is available
    bool isEmpty() { return typeVec.empty(); }
-   void init(const QString &expectedSha);
+   bool operator==(const Lanes &lanes) const;
+   bool operator!=(const Lanes &lanes) const { return !(*this == lanes); }
+   void init(qint32 expectedId);
    void clear();
-   bool isFork(const QString &sha, bool &isDiscontinuity);
-   void setFork(const QString &sha);
-   void setMerge(const QStringList &parents);
+   bool isFork(qint32 id, bool &isDiscontinuity);
+   void setFork(qint32 id);
+   void setMerge(const Parents &parents);
    void setInitial();
-   void changeActiveLane(const QString &sha);
+   void changeActiveLane(qint32 id);
    void afterMerge();
    void afterFork();
    bool isBranch();
    void afterBranch();
-   void nextParent(const QString &sha);
+   void nextParent(qint32 id);
    void setLanes(QVector<Lane> &ln) { ln = typeVec; } // O(1) vector is implicitly shared
    QVector<Lane> getLanes() const { return typeVec; }
+   // Lays out the next row of the graph and moves to the one after it.
+   QVector<Lane> calculate(qint32 id, const Parents &parents);
 
 private:
-   int findNextSha(const QString &next, int pos);
+   void reset(const Parents &parents, bool isFork);
+   int findNextId(qint32 next, int pos) const;
    int findType(LaneType type, int pos);
-   int add(LaneType type, const QString &next, int pos);
+   int add(LaneType type, qint32 next, int pos);
    bool isNode(Lane lane) const;
 
-   int activeLane;
+   int activeLane = 0;
    QVector<Lane> typeVec; // Describes which glyphs should be drawn.
-   QVector<QString> nextShaVec; // The sha1 hashes of the next commit to appear in each lane (column).
+   QVector<qint32> nextIdVec; // The ids of the next commit to appear in each lane (column).
    LaneType NODE = LaneType::MERGE_FORK;
    LaneType NODE_R = LaneType::MERGE_FORK_R;
    LaneType NODE_L = LaneType::MERGE_FORK_L;
@@ -18,11 +18,24 @@ AmendWidget::AmendWidget(const QSharedPointer<GitCache> &cache, const QSharedPoi
    : CommitChangesWidget(cache, git, parent)
 {
    ui->pbCommit->setText(tr("Amend"));
+
+   // The description is set once the body is read if it was not loaded with the commit.
+   connect(mGit.data(), &GitBase::signalCommitBodyLoaded, this, [this](const QString &sha) {
+      if (sha == mCurrentSha && ui->teDescription->toPlainText().isEmpty())
+      {
+         auto commit = mCache->getCommitInfo(sha);
+
+         if (mGit->loadCommitBody(commit))
+            ui->teDescription->setPlainText(commit.longLog().trimmed());
+      }
+   });
 }
 
 void AmendWidget::configure(const QString &sha)
 {
-   const auto commit = mCache->getCommitInfo(sha);
+   auto commit = mCache->getCommitInfo(sha);
+
+   mGit->loadCommitBody(commit);
 
    ui->amendFrame->setVisible(true);
    ui->pbCancelAmend->setVisible(true);
@@ -3,6 +3,7 @@
 #include <GitCache.h>
 #include <CommitInfo.h>
 #include <FileListWidget.h>
+#include <GitBase.h>
 
 #include <QLabel>
 #include <QVBoxLayout>
@@ -22,6 +23,16 @@ CommitInfoWidget::CommitInfoWidget(const QSharedPointer<GitCache> &cache, const
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
+   // The panel is configured again once the body is read if it was not loaded with the commit.
+   connect(mGit.data(), &GitBase::signalCommitBodyLoaded, this, [this](const QString &sha) {
+      if (sha == mCurrentSha)
+      {
+         auto commit = mCache->getCommitInfo(sha);
+         mGit->loadCommitBody(commit);
+         mInfoPanel->configure(commit);
+      }
+   });
+
    fileListWidget->setObjectName("fileListWidget");
 
    const auto verticalLayout = new QVBoxLayout(this);
@@ -48,10 +59,12 @@ void CommitInfoWidget::configure(const QString &sha)
 
    if (sha != CommitInfo::ZERO_SHA && !sha.isEmpty())
    {
-      const auto commit = mCache->getCommitInfo(sha);
+      auto commit = mCache->getCommitInfo(sha);
 
       if (!commit.sha().isEmpty())
       {
+         mGit->loadCommitBody(commit);
+
          QLog_Info("UI", QString("Loading information of the commit {%1}").arg(sha));
          mCurrentSha = commit.sha();
          mParentSha = commit.parent(0);
@@ -108,9 +108,15 @@ void GeneralConfigDlg::resetChanges()
 void GeneralConfigDlg::accept()
 {
    GitQlientSettings settings;
+   const auto colorSchemaChanged
+       = settings.globalValue("colorSchema", "bright").toString() != mStylesSchema->currentText();
+
    settings.setGlobalValue("logsDisabled", mDisableLogs->isChecked());
    settings.setGlobalValue("logsLevel", mLevelCombo->currentIndex());
    settings.setGlobalValue("colorSchema", mStylesSchema->currentText());
+
+   if (colorSchemaChanged)
+      GitQlientStyles::notifyColorsChanged();
    settings.setGlobalValue("gitLocation", mGitLocation->text());
 
    if (mShowResetMsg)
@@ -49,7 +49,5 @@ protected:
    bool mCanceling = false;
    bool execute(const QString &command);
    virtual void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
-
-private:
-   void onReadyStandardOutput();
+   virtual void onReadyStandardOutput();
 };
@@ -10,12 +10,14 @@ HEADERS += \
     $$PWD/GitExecResult.h \
     $$PWD/GitHistory.h \
     $$PWD/GitLocal.h \
+    $$PWD/GitLogParser.h \
     $$PWD/GitMerge.h \
     $$PWD/GitPatches.h \
     $$PWD/GitRemote.h \
     $$PWD/GitRepoLoader.h \
     $$PWD/GitRequestorProcess.h \
     $$PWD/GitStashes.h \
+    $$PWD/GitStreamProcess.h \
     $$PWD/GitSubmodules.h \
     $$PWD/GitSyncProcess.h \
     $$PWD/GitTags.h
@@ -30,12 +32,14 @@ SOURCES += \
     $$PWD/GitExecResult.cpp \
     $$PWD/GitHistory.cpp \
     $$PWD/GitLocal.cpp \
+    $$PWD/GitLogParser.cpp \
     $$PWD/GitMerge.cpp \
     $$PWD/GitPatches.cpp \
     $$PWD/GitRemote.cpp \
     $$PWD/GitRepoLoader.cpp \
     $$PWD/GitRequestorProcess.cpp \
     $$PWD/GitStashes.cpp \
+    $$PWD/GitStreamProcess.cpp \
     $$PWD/GitSubmodules.cpp \
     $$PWD/GitSyncProcess.cpp \
     $$PWD/GitTags.cpp
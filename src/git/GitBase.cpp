@@ -2,6 +2,7 @@
 
 #include <GitSyncProcess.h>
 #include <GitAsyncProcess.h>
+#include <GitQlientSettings.h>
 
 #include <QLogger.h>
 
@@ -9,11 +10,18 @@ using namespace QLogger;
 
 #include <QDir>
 #include <QFileInfo>
+#include <QProcess>
+
+namespace
+{
+const int MAX_CACHED_BODIES = 200;
+}
 
 GitBase::GitBase(const QString &workingDirectory, QObject *parent)
    : QObject(parent)
    , mWorkingDirectory(workingDirectory)
    , mGitDirectory(mWorkingDirectory + "/.git")
+   , mCommitBodies(MAX_CACHED_BODIES)
 {
    QFileInfo fileInfo(mGitDirectory);
 
@@ -30,6 +38,11 @@ GitBase::GitBase(const QString &workingDirectory, QObject *parent)
    }
 }
 
+GitBase::~GitBase()
+{
+   stopCatFileBatch();
+}
+
 QString GitBase::getWorkingDir() const
 {
    return mWorkingDirectory;
@@ -37,6 +50,12 @@ QString GitBase::getWorkingDir() const
 
 void GitBase::setWorkingDir(const QString &workingDir)
 {
+   if (mWorkingDirectory != workingDir)
+   {
+      stopCatFileBatch();
+      mCommitBodies.clear();
+   }
+
    mWorkingDirectory = workingDir;
 }
 
@@ -109,3 +128,116 @@ GitExecResult GitBase::getLastCommit() const
 
    return ret;
 }
+
+bool GitBase::loadCommitBody(CommitInfo &commit)
+{
+   if (commit.isLongLogLoaded())
+      return true;
+
+   const auto sha = commit.sha();
+
+   if (const auto body = mCommitBodies.object(sha))
+   {
+      commit.setLongLog(*body);
+      return true;
+   }
+
+   if (!mPendingBodies.contains(sha) && startCatFileBatch())
+   {
+      mCatFileBatch->write(sha.toLatin1().append('\n'));
+      mPendingBodies.append(sha);
+   }
+
+   return false;
+}
+
+bool GitBase::startCatFileBatch()
+{
+   if (mCatFileBatch && mCatFileBatch->state() == QProcess::Running)
+      return true;
+
+   stopCatFileBatch();
+
+   GitQlientSettings settings;
+   const auto gitAlternative = settings.globalValue("gitLocation", "").toString();
+
+   mCatFileBatch = new QProcess(this);
+   mCatFileBatch->setWorkingDirectory(mWorkingDirectory);
+   connect(mCatFileBatch, &QProcess::readyReadStandardOutput, this, &GitBase::readCatFileBatch);
+   mCatFileBatch->start(gitAlternative.isEmpty() ? QString("git") : gitAlternative, { "cat-file", "--batch" });
+
+   if (!mCatFileBatch->waitForStarted())
+   {
+      QLog_Warning("Git", QString("Unable to start git cat-file:\n%1").arg(mCatFileBatch->errorString()));
+      stopCatFileBatch();
+      return false;
+   }
+
+   return true;
+}
+
+void GitBase::stopCatFileBatch()
+{
+   if (mCatFileBatch)
+   {
+      mCatFileBatch->closeWriteChannel();
+
+      if (!mCatFileBatch->waitForFinished(1000))
+         mCatFileBatch->kill();
+
+      delete mCatFileBatch;
+      mCatFileBatch = nullptr;
+   }
+
+   // The requests without answer are lost with the process.
+   mPendingBodies.clear();
+   mCatFileBuffer.clear();
+}
+
+void GitBase::readCatFileBatch()
+{
+   mCatFileBuffer.append(mCatFileBatch->readAllStandardOutput());
+
+   // Every answer is a header "<sha> commit <size>" followed by the raw object and a new line. Missing objects only
+   // have the header.
+   while (!mPendingBodies.isEmpty())
+   {
+      const auto headerEnd = mCatFileBuffer.indexOf('\n');
+
+      if (headerEnd == -1)
+         return;
+
+      const auto header = mCatFileBuffer.left(headerEnd).trimmed().split(' ');
+      const auto objectStart = headerEnd + 1;
+      auto answerEnd = objectStart;
+      QString body;
+
+      if (header.count() == 3)
+      {
+         const auto size = header.at(2).toInt();
+
+         if (mCatFileBuffer.size() < objectStart + size + 1)
+            return;
+
+         const auto object = mCatFileBuffer.mid(objectStart, size);
+
+         // The message starts after the headers and the body after the subject paragraph.
+         if (const auto messageStart = object.indexOf("\n\n"); header.at(1) == "commit" && messageStart != -1)
+         {
+            if (const auto bodyStart = object.indexOf("\n\n", messageStart + 2); bodyStart != -1)
+               body = QString::fromUtf8(object.mid(bodyStart + 2)).trimmed();
+         }
+
+         answerEnd = objectStart + size + 1;
+      }
+      else
+         QLog_Warning("Git", QString("Unable to read the commit {%1} with git cat-file.").arg(mPendingBodies.first()));
+
+      mCatFileBuffer.remove(0, answerEnd);
+
+      const auto sha = mPendingBodies.takeFirst();
+      mCommitBodies.insert(sha, new QString(body));
+
+      emit signalCommitBodyLoaded(sha);
+   }
+}
@@ -28,6 +28,9 @@
 
 #include <QObject>
 #include <QSharedPointer>
+#include <QCache>
+
+class QProcess;
 
 class GitBase final : public QObject
 {
@@ -36,9 +39,15 @@ class GitBase final : public QObject
 signals:
    void cancelAllProcesses(QPrivateSignal);
    void signalResultReady(GitExecResult result);
+   /**
+    * @brief signalCommitBodyLoaded Signal triggered when the body requested by @ref loadCommitBody has been read.
+    * @param sha The SHA of the commit.
+    */
+   void signalCommitBodyLoaded(const QString &sha);
 
 public:
    explicit GitBase(const QString &workingDirectory, QObject *parent = nullptr);
+   ~GitBase();
 
    GitExecResult run(const QString &cmd) const;
 
@@ -56,8 +65,28 @@ public:
 
    GitExecResult getLastCommit() const;
 
+   /**
+    * @brief loadCommitBody Sets the body of a commit (the message without the subject) if it was loaded without it.
+    * The bodies are read asynchronously through a `git cat-file --batch` process that is kept alive between calls and
+    * the last ones are kept in memory. If the body wasn't read yet, it's requested and @ref signalCommitBodyLoaded is
+    * emitted once it's available. It must be called from the thread that owns the object.
+    *
+    * @param commit The commit.
+    * @return True if the commit has its body, false if it's being read.
+    */
+   bool loadCommitBody(CommitInfo &commit);
+
 protected:
    QString mWorkingDirectory;
    QString mGitDirectory;
    QString mCurrentBranch;
+   QProcess *mCatFileBatch = nullptr;
+   QCache<QString, QString> mCommitBodies;
+   // The requests sent to git cat-file that are not answered yet, in the order of the answers.
+   QStringList mPendingBodies;
+   QByteArray mCatFileBuffer;
+
+   bool startCatFileBatch();
+   void stopCatFileBatch();
+   void readCatFileBatch();
 };
@@ -0,0 +1,238 @@
+#include "GitLogParser.h"
+
+#include <QThread>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+// Below these sizes the cost of dispatching the work to the thread pool is higher than parsing sequentially.
+const int MIN_PARALLEL_LOG_SIZE = 1024 * 1024;
+const int MIN_RECORDS_PER_CHUNK = 2000;
+const int CHUNKS_PER_THREAD = 4;
+
+QList<CommitInfo> collectResults(QVector<QFuture<QList<CommitInfo>>> &futures)
+{
+   QList<CommitInfo> commits;
+
+   for (auto &future : futures)
+      commits.append(future.result());
+
+   return commits;
+}
+
+struct Slice
+{
+   const char *data = nullptr;
+   int size = 0;
+};
+
+bool nextLine(const char *&pos, const char *end, Slice &line)
+{
+   if (pos >= end)
+      return false;
+
+   const auto newLine = static_cast<const char *>(std::memchr(pos, '\n', static_cast<size_t>(end - pos)));
+
+   if (!newLine)
+      return false;
+
+   line = { pos, static_cast<int>(newLine - pos) };
+   pos = newLine + 1;
+
+   return true;
+}
+
+bool isSpace(char c)
+{
+   return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+Slice trimmed(Slice slice)
+{
+   while (slice.size > 0 && isSpace(*slice.data))
+   {
+      ++slice.data;
+      --slice.size;
+   }
+
+   while (slice.size > 0 && isSpace(slice.data[slice.size - 1]))
+      --slice.size;
+
+   return slice;
+}
+
+QString toString(const Slice &slice)
+{
+   return QString::fromUtf8(slice.data, slice.size);
+}
+
+qint64 toNumber(const Slice &slice)
+{
+   qint64 value = 0;
+
+   for (auto i = 0; i < slice.size && slice.data[i] >= '0' && slice.data[i] <= '9'; ++i)
+      value = value * 10 + (slice.data[i] - '0');
+
+   return value;
+}
+
+bool contains(const Slice &slice, const char *text)
+{
+   const auto length = static_cast<int>(std::strlen(text));
+
+   for (auto i = 0; i + length <= slice.size; ++i)
+   {
+      if (std::memcmp(slice.data + i, text, static_cast<size_t>(length)) == 0)
+         return true;
+   }
+
+   return false;
+}
+}
+
+CommitInfo GitLogParser::parseRecord(const char *data, int size)
+{
+   // Record layout: <log size or GPG key>\n<mark><sha>X<parents>\n<committer>\n<author>\n<date>\n<subject>\n<body>
+   const char *pos = data;
+   const char *end = data + size;
+   Slice header;
+   Slice shas;
+   Slice committer;
+   Slice author;
+   Slice date;
+   Slice subject;
+
+   if (!nextLine(pos, end, header) || !nextLine(pos, end, shas) || !nextLine(pos, end, committer)
+       || !nextLine(pos, end, author) || !nextLine(pos, end, date) || !nextLine(pos, end, subject))
+   {
+      return CommitInfo();
+   }
+
+   // The first character is the boundary mark, followed by the SHA and the 'X' separator.
+   if (shas.size < 1 + CommitOid::HEX_LENGTH)
+      return CommitInfo();
+
+   const auto oid = CommitOid::fromHex(shas.data + 1, CommitOid::HEX_LENGTH);
+
+   if (!oid.isValid())
+      return CommitInfo();
+
+   QVector<CommitOid> parents;
+   const auto parentsEnd = shas.data + shas.size;
+
+   for (auto parent = shas.data + 1 + CommitOid::HEX_LENGTH + 1; parent < parentsEnd;)
+   {
+      auto parentEnd = parent;
+
+      while (parentEnd < parentsEnd && *parentEnd != ' ')
+         ++parentEnd;
+
+      if (const auto parentOid = CommitOid::fromHex(parent, static_cast<int>(parentEnd - parent)); parentOid.isValid())
+         parents.append(parentOid);
+
+      parent = parentEnd + 1;
+   }
+
+   const auto isSigned = header.size > 0 && !contains(header, "log size");
+   const auto body = trimmed({ pos, static_cast<int>(end - pos) });
+
+   return CommitInfo { oid,
+                       parents,
+                       QChar(QLatin1Char(*shas.data)),
+                       toString(committer),
+                       QDateTime::fromSecsSinceEpoch(toNumber(date)),
+                       toString(author),
+                       toString(subject),
+                       QByteArray(body.data, body.size),
+                       isSigned,
+                       isSigned ? toString(header) : QString() };
+}
+
+QList<CommitInfo> GitLogParser::parseLog(const QByteArray &log)
+{
+   const auto size = log.size();
+   const auto threads = QThread::idealThreadCount();
+
+   if (size < MIN_PARALLEL_LOG_SIZE || threads < 2)
+      return parseLogRange(log, 0, size);
+
+   const auto chunkSize = std::max(size / (threads * CHUNKS_PER_THREAD), MIN_PARALLEL_LOG_SIZE / CHUNKS_PER_THREAD);
+   QVector<QFuture<QList<CommitInfo>>> futures;
+   auto chunkStart = 0;
+
+   while (chunkStart < size)
+   {
+      // The chunk is extended until the next separator so no record is split between two workers.
+      auto chunkEnd = chunkStart + chunkSize < size ? log.indexOf('\000', chunkStart + chunkSize) : size;
+
+      if (chunkEnd == -1)
+         chunkEnd = size;
+
+      futures.append(
+          QtConcurrent::run([&log, chunkStart, chunkEnd]() { return parseLogRange(log, chunkStart, chunkEnd); }));
+
+      chunkStart = chunkEnd + 1;
+   }
+
+   return collectResults(futures);
+}
+
+QList<CommitInfo> GitLogParser::parseRecords(const QVector<QByteArray> &records)
+{
+   const auto parseChunk = [&records](int from, int to) {
+      QList<CommitInfo> commits;
+
+      for (auto i = from; i < to; ++i)
+      {
+         if (auto commit = parseRecord(records.at(i).constData(), records.at(i).size()); commit.isValid())
+            commits.append(std::move(commit));
+      }
+
+      return commits;
+   };
+
+   const auto count = records.count();
+   const auto threads = QThread::idealThreadCount();
+
+   if (count < MIN_RECORDS_PER_CHUNK * 2 || threads < 2)
+      return parseChunk(0, count);
+
+   const auto chunkSize = std::max(count / (threads * CHUNKS_PER_THREAD), MIN_RECORDS_PER_CHUNK);
+   QVector<QFuture<QList<CommitInfo>>> futures;
+
+   for (auto chunkStart = 0; chunkStart < count; chunkStart += chunkSize)
+   {
+      const auto chunkEnd = std::min(chunkStart + chunkSize, count);
+
+      futures.append(
+          QtConcurrent::run([parseChunk, chunkStart, chunkEnd]() { return parseChunk(chunkStart, chunkEnd); }));
+   }
+
+   return collectResults(futures);
+}
+
+QList<CommitInfo> GitLogParser::parseLogRange(const QByteArray &log, int from, int to)
+{
+   QList<CommitInfo> commits;
+   const auto data = log.constData();
+   auto recordStart = from;
+
+   while (recordStart < to)
+   {
+      auto recordEnd = log.indexOf('\000', recordStart);
+
+      if (recordEnd == -1 || recordEnd > to)
+         recordEnd = to;
+
+      if (auto commit = parseRecord(data + recordStart, recordEnd - recordStart); commit.isValid())
+         commits.append(std::move(commit));
+
+      recordStart = recordEnd + 1;
+   }
+
+   return commits;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitInfo.h>
+
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+/**
+ * @brief The GitLogParser class parses the output of `git log -z` with the GitQlient log format working directly over
+ * the raw bytes. The records are not copied nor split in intermediate strings: the SHAs are decoded straight to their
+ * binary representation and only the fields that are shown in the UI are decoded from UTF-8. The body of the commit
+ * is kept as UTF-8 and decoded when it's requested.
+ *
+ * @class GitLogParser GitLogParser.h "GitLogParser.h"
+ */
+class GitLogParser
+{
+public:
+   /**
+    * @brief Parses a single commit record.
+    *
+    * @param data The start of the record.
+    * @param size The size of the record in bytes.
+    * @return CommitInfo The commit. It's not valid if the record is malformed.
+    */
+   static CommitInfo parseRecord(const char *data, int size);
+   /**
+    * @brief Parses all the NUL separated records contained in @p log. Big logs are split at record boundaries and the
+    * chunks are parsed in the global thread pool.
+    *
+    * @param log The output of `git log -z`.
+    * @return QList<CommitInfo> The valid commits in the same order they appear in the log.
+    */
+   static QList<CommitInfo> parseLog(const QByteArray &log);
+   /**
+    * @brief Parses a list of records that were already split. Like @ref parseLog, big lists are parsed in the global
+    * thread pool.
+    *
+    * @param records The commit records.
+    * @return QList<CommitInfo> The valid commits in the same order of @p records.
+    */
+   static QList<CommitInfo> parseRecords(const QVector<QByteArray> &records);
+
+private:
+   static QList<CommitInfo> parseLogRange(const QByteArray &log, int from, int to);
+};
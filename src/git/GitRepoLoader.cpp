@@ -3,24 +3,51 @@
 #include <GitBase.h>
 #include <GitConfig.h>
 #include <GitCache.h>
+#include <GitLogParser.h>
 #include <GitRequestorProcess.h>
-#include <GitBranches.h>
+#include <GitStreamProcess.h>
 #include <GitQlientSettings.h>
 #include <GitHubRestApi.h>
 
 #include <QLogger.h>
 
 #include <QDir>
+#include <QMap>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
 
 using namespace QLogger;
 
 static const char *GIT_LOG_FORMAT("%m%HX%P%n%cn<%ce>%n%an<%ae>%n%at%n%s%n%b ");
+static const char *GIT_LOG_FORMAT_NO_BODY("%m%HX%P%n%cn<%ce>%n%an<%ae>%n%at%n%s%n ");
+
+// The first batch is small so the top of the history is shown as soon as possible. The following ones grow to keep the
+// number of model updates low while the rest of the log is still being received.
+static const int FIRST_STREAM_BATCH = 500;
+static const int MAX_STREAM_BATCH = 50000;
+
+// The incremental updates only write the commits cache file if it wasn't written during this time. The last changes are
+// written when the loader is destroyed.
+static const int GRAPH_CACHE_WRITE_INTERVAL = 5 * 60 * 1000;
+
+// The missing commits are requested passing the tips in the command line, that is limited to 32K characters in Windows.
+static const int MAX_GRAPH_CACHE_TIPS = 700;
 
 GitRepoLoader::GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<GitCache> cache, QObject *parent)
    : QObject(parent)
    , mGitBase(gitBase)
    , mRevCache(std::move(cache))
 {
+   // The distances are not needed to show the graph, so they are calculated once it's loaded.
+   connect(this, &GitRepoLoader::signalLoadingFinished, this, &GitRepoLoader::loadLocalBranchDistances,
+           Qt::QueuedConnection);
+}
+
+GitRepoLoader::~GitRepoLoader()
+{
+   if (mGraphCacheOutdated && !mLocked)
+      storeGraphCache();
 }
 
 bool GitRepoLoader::loadRepository()
@@ -89,6 +116,10 @@ void GitRepoLoader::loadReferences()
 
       QString prevRefSha;
 
+      mLocalBranchesShas.clear();
+      mRemoteBranchesShas.clear();
+      mUnloadedReferences.clear();
+
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
       const auto referencesList = ret3.output.toString().split('\n', Qt::SkipEmptyParts);
 #else
@@ -126,42 +157,124 @@ void GitRepoLoader::loadReferences()
             else
                continue;
 
-            mRevCache->insertReference(revSha, type, name);
+            // The references of the commits that are not loaded yet are added with the page that loads them.
+            if (!mRevCache->insertReference(revSha, type, name) && mPageSize > 0)
+               mUnloadedReferences.insert(revSha, qMakePair(type, name));
 
             if (localBranches)
-            {
-               const auto git = new GitBranches(mGitBase);
-               GitCache::LocalBranchDistances distances;
-
-               const auto distToMaster = git->getDistanceBetweenBranches(true, name);
-               auto toMaster = distToMaster.output.toString();
-
-               if (!toMaster.contains("fatal"))
-               {
-                  toMaster.replace('\n', "");
-                  const auto values = toMaster.split('\t');
-                  distances.behindMaster = values.first().toUInt();
-                  distances.aheadMaster = values.last().toUInt();
-               }
-
-               const auto distToOrigin = git->getDistanceBetweenBranches(false, name);
-               auto toOrigin = distToOrigin.output.toString();
-
-               if (!toOrigin.contains("fatal"))
-               {
-                  toOrigin.replace('\n', "");
-                  const auto values = toOrigin.split('\t');
-                  distances.behindOrigin = values.first().toUInt();
-                  distances.aheadOrigin = values.last().toUInt();
-               }
-
-               mRevCache->insertLocalBranchDistances(name, distances);
-            }
+               mLocalBranchesShas.insert(name, revSha);
+            else if (type == References::Type::RemoteBranches)
+               mRemoteBranchesShas.insert(name, revSha);
          }
 
          prevRefSha = revSha;
       }
    }
+
+   // The references are only visible to the GUI once they are published with the graph.
+   mRevCache->publishSnapshot();
+}
+
+void GitRepoLoader::loadLocalBranchDistances()
+{
+   QLog_Debug("Git", "Loading the distances of the local branches.");
+
+   const auto localBranches = mLocalBranchesShas;
+   const auto remoteBranches = mRemoteBranchesShas;
+
+   // The remote of every branch is read from the local config at once (branch.<name>.remote=<remote>).
+   QMap<QString, QString> remotes;
+   QScopedPointer<GitConfig> gitConfig(new GitConfig(mGitBase));
+
+   if (const auto config = gitConfig->getLocalConfig(); config.success)
+   {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+      const auto values = config.output.toString().split('\n', Qt::SkipEmptyParts);
+#else
+      const auto values = config.output.toString().split('\n', QString::SkipEmptyParts);
+#endif
+
+      for (const auto &value : values)
+      {
+         const auto key = value.section('=', 0, 0);
+
+         if (key.startsWith("branch.") && key.endsWith(".remote"))
+            remotes.insert(key.mid(7, key.length() - 14), value.section('=', 1));
+      }
+   }
+
+   const auto remoteSha = [&remotes, &localBranches, &remoteBranches](const QString &branch) {
+      const auto remote = remotes.value(branch);
+      return remote.isEmpty() ? localBranches.value(branch)
+                              : remoteBranches.value(QString("%1/%2").arg(remote, branch));
+   };
+
+   const auto masterSha = remoteSha(QString("master"));
+
+   // Every local branch is compared against master and against its remote. The pairs are stored in the same order as
+   // the branches: the one against master first (if master exists) and then the one against the remote (if any).
+   QVector<QPair<QString, QString>> pairs;
+   QVector<int> masterPairs;
+   QVector<int> originPairs;
+
+   for (auto iter = localBranches.cbegin(); iter != localBranches.cend(); ++iter)
+   {
+      masterPairs.append(masterSha.isEmpty() ? -1 : pairs.count());
+
+      if (!masterSha.isEmpty())
+         pairs.append(qMakePair(iter.value(), masterSha));
+
+      const auto originSha = remoteSha(iter.key());
+      const auto hasOrigin = iter.key() != "master" && !remotes.value(iter.key()).isEmpty() && !originSha.isEmpty();
+
+      originPairs.append(hasOrigin ? pairs.count() : -1);
+
+      if (hasOrigin)
+         pairs.append(qMakePair(iter.value(), originSha));
+   }
+
+   const auto distance = [this, &pairs](int pairIdx, const QVector<QPair<int, int>> &distances) {
+      if (pairIdx == -1 || distances.at(pairIdx).first != -1)
+         return pairIdx == -1 ? qMakePair(0, 0) : distances.at(pairIdx);
+
+      const auto ret = mGitBase->run(
+          QString("git rev-list --left-right --count %1...%2").arg(pairs.at(pairIdx).first, pairs.at(pairIdx).second));
+      const auto values = ret.output.toString().trimmed().split('\t');
+
+      return ret.success && values.count() == 2 ? qMakePair(values.first().toInt(), values.last().toInt())
+                                                : qMakePair(0, 0);
+   };
+
+   auto branchIdx = 0;
+   auto branch = localBranches.cbegin();
+
+   // The branches are notified as soon as the distances of their pairs are ready.
+   const auto notifyBranches = [&](int pairsDone, const QVector<QPair<int, int>> &distances) {
+      for (; branch != localBranches.cend(); ++branch, ++branchIdx)
+      {
+         if (std::max(masterPairs.at(branchIdx), originPairs.at(branchIdx)) >= pairsDone)
+            return;
+
+         const auto toMaster = distance(masterPairs.at(branchIdx), distances);
+         const auto toOrigin = distance(originPairs.at(branchIdx), distances);
+
+         GitCache::LocalBranchDistances branchDistances;
+         branchDistances.aheadMaster = toMaster.first;
+         branchDistances.behindMaster = toMaster.second;
+         branchDistances.aheadOrigin = toOrigin.first;
+         branchDistances.behindOrigin = toOrigin.second;
+
+         mRevCache->insertLocalBranchDistances(branch.key(), branchDistances);
+
+         emit signalLocalBranchDistancesLoaded(branch.key());
+      }
+   };
+
+   // The walk over the graph is only accurate if it contains all the references and the full history.
+   if (mGraphCacheKey.isValid())
+      mRevCache->getDistances(pairs, notifyBranches);
+
+   notifyBranches(pairs.count(), QVector<QPair<int, int>>(pairs.count(), qMakePair(-1, -1)));
 }
 
 void GitRepoLoader::requestRevisions()
@@ -173,23 +286,257 @@ void GitRepoLoader::requestRevisions()
    const auto commitsToRetrieve = maxCommits != 0 ? QString::fromUtf8("-n %1").arg(maxCommits)
                                                   : mShowAll ? QString("--all") : mGitBase->getCurrentBranch();
 
+   // With a page size the history is loaded in pages when the view needs them instead of all at once.
+   auto pageSize = settings.localValue(mGitBase->getGitQlientSettingsDir(), "HistoryPageSize", 0).toInt();
+
+   if (maxCommits != 0 || pageSize < 0)
+      pageSize = 0;
+
+   // The bodies can be left out of the log and read on demand to keep the memory low in repos with long messages.
+   mLazyBodies = settings.localValue(mGitBase->getGitQlientSettingsDir(), "LazyCommitBodies", false).toBool();
+
+   const auto revisionFilesBudget = settings.localValue(mGitBase->getGitQlientSettingsDir(), "RevisionFilesCacheSize",
+                                                        GitCache::DEFAULT_REVISION_FILES_BUDGET_MB);
+   mRevCache->setRevisionFilesBudget(revisionFilesBudget.toInt());
+
    const auto baseCmd = QString("git log --date-order --no-color --log-size --parents --boundary -z --pretty=format:")
-                            .append(QString::fromUtf8(GIT_LOG_FORMAT))
+                            .append(getLogFormat())
                             .append(commitsToRetrieve);
 
+   QScopedPointer<GitConfig> gitConfig(new GitConfig(mGitBase));
+   const auto ret = gitConfig->getGitValue("log.showSignature");
+   const auto showSignature = ret.success ? ret.output.toString().contains("true") : false;
+
+   // Only the complete graphs with all the references can be updated incrementally or stored in the cache file.
+   const auto completeGraph = maxCommits == 0 && pageSize == 0 && mShowAll && !showSignature;
+   const auto loadedKey = mLoadedGraphKey;
+
+   stopPageStream();
+
+   mPageSize = pageSize;
+   mHasMorePages = false;
+
+   emit signalMoreRevisionsAvailable(false);
+
+   mLoadedGraphKey = {};
+   mGraphCacheKey = completeGraph ? getGraphCacheKey() : CommitGraphCache::Key();
+   mGraphCacheKey.withBodies = !mLazyBodies;
+   mStoreGraphCache = mGraphCacheKey.isValid()
+       && settings.localValue(mGitBase->getGitQlientSettingsDir(), "CommitGraphCache", true).toBool();
+
+   // The incremental update is fast enough to not block the UI with the loading dialog.
+   if (mGraphCacheKey.isValid() && updateLoadedGraph(loadedKey))
+      return;
+
+   // The full load writes the file once it finishes if the graph is complete.
+   mGraphCacheOutdated = false;
+
    emit signalLoadingStarted(1);
 
-   const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
-   connect(requestor, &GitRequestorProcess::procDataReady, this, &GitRepoLoader::processRevision);
-   connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
+   if (mStoreGraphCache && loadFromGraphCache())
+      return;
 
-   requestor->run(baseCmd);
+   if (mPageSize > 0)
+   {
+      requestRevisionsPaged(commitsToRetrieve, showSignature);
+      return;
+   }
+
+   // The signed log mixes the GPG output with the commits so it can't be split by records until it's complete.
+   if (!showSignature && settings.localValue(mGitBase->getGitQlientSettingsDir(), "StreamingLoad", true).toBool())
+      requestRevisionsStream(baseCmd);
+   else
+   {
+      const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
+      connect(requestor, &GitRequestorProcess::procDataReady, this, &GitRepoLoader::processRevision);
+      connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
+
+      requestor->run(baseCmd);
+   }
 }
 
-void GitRepoLoader::processRevision(QByteArray ba)
+void GitRepoLoader::requestRevisionsStream(const QString &cmd)
 {
-   QLog_Info("Git", "Revisions received!");
+   QLog_Debug("Git", "Streaming revisions.");
+
+   requestPrsStatus();
+
+   mStreamBuffer.clear();
+   mStreamedCommits.clear();
+   mStreamBatchSize = FIRST_STREAM_BATCH;
+
+   // The WIP is the first row of the graph so it needs to be in the cache before any commit arrives.
+   mRevCache->setup(processWip(), {});
+
+   const auto process = new GitStreamProcess(mGitBase->getWorkingDir());
+   connect(process, &GitStreamProcess::signalDataChunk, this, &GitRepoLoader::processRevisionChunk);
+   connect(process, &GitStreamProcess::signalStreamFinished, this, &GitRepoLoader::processRevisionStreamEnd);
+   connect(this, &GitRepoLoader::cancelAllProcesses, process, &AGitProcess::onCancel);
+
+   if (!process->run(cmd).success)
+   {
+      process->deleteLater();
+      processRevisionStreamEnd(false);
+   }
+}
+
+void GitRepoLoader::requestRevisionsPaged(const QString &revisions, bool showSignature)
+{
+   QLog_Debug("Git", QString("Loading revisions in pages of {%1}.").arg(mPageSize));
+
+   requestPrsStatus();
+
+   mPageSigned = showSignature;
+   mPagePending.clear();
+
+   // Every page is a log limited to its size, so only one page is kept in memory at a time. The first one starts
+   // from the references and the following ones from the commits the previous pages didn't reach.
+   mPageCmd = QString("git log --date-order --no-color --log-size --parents -z -n %1 --pretty=format:")
+                  .arg(mPageSize)
+                  .append(getLogFormat());
+
+   requestPage(mPageCmd + revisions);
+}
+
+void GitRepoLoader::requestPage(const QString &cmd, const QByteArray &input)
+{
+   mPageRequested = true;
+   mStreamBuffer.clear();
+
+   const auto process = new GitStreamProcess(mGitBase->getWorkingDir());
+   mPageStream = process;
+   connect(process, &GitStreamProcess::signalDataChunk, this, &GitRepoLoader::processPageChunk);
+   connect(process, &GitStreamProcess::signalStreamFinished, this, &GitRepoLoader::processPageStreamEnd);
+   connect(this, &GitRepoLoader::cancelAllProcesses, process, &AGitProcess::onCancel);
+
+   if (!process->run(cmd, input).success)
+   {
+      process->deleteLater();
+      processPageStreamEnd(false);
+   }
+}
+
+void GitRepoLoader::processPageChunk(const QByteArray &chunk)
+{
+   mStreamBuffer.append(chunk);
+}
 
+void GitRepoLoader::processPageStreamEnd(bool success)
+{
+   QLog_Info("Git", QString("Revisions page finished %1.").arg(success ? "successfully" : "with errors"));
+
+   mPageRequested = false;
+
+   const auto commits = mPageSigned ? processSignedLog(mStreamBuffer) : processUnsignedLog(mStreamBuffer);
+
+   mStreamBuffer.clear();
+
+   loadPage(commits, success);
+}
+
+void GitRepoLoader::stopPageStream()
+{
+   // The pages of a previous load must not reach the new graph.
+   if (mPageStream)
+   {
+      disconnect(mPageStream, nullptr, this, nullptr);
+      mPageStream->kill();
+   }
+
+   mPageRequested = false;
+   mStreamBuffer.clear();
+}
+
+void GitRepoLoader::loadPage(const QList<CommitInfo> &commits, bool success)
+{
+   // The log is in date order, so the parents of a commit are never in a page before it. The parents of the page that
+   // are not in it are the ones the next page starts from.
+   for (const auto &commit : commits)
+   {
+      for (const auto &parent : commit.parentOids())
+         mPagePending.insert(parent);
+   }
+
+   for (const auto &commit : commits)
+      mPagePending.remove(commit.oid());
+
+   // The first page configures the cache and finishes the load.
+   if (mLocked)
+   {
+      mRevCache->setup(processWip(), commits);
+
+      loadReferences();
+
+      // With all the branches, the ones that the first page didn't reach are also walked by the next pages.
+      if (mShowAll)
+      {
+         for (auto iter = mUnloadedReferences.cbegin(); iter != mUnloadedReferences.cend(); ++iter)
+         {
+            if (const auto oid = CommitOid::fromString(iter.key()); oid.isValid())
+               mPagePending.insert(oid);
+         }
+      }
+
+      mRevCache->setConfigurationDone();
+
+      mHasMorePages = success && commits.count() >= mPageSize && !mPagePending.isEmpty();
+      mLocked = false;
+
+      emit signalMoreRevisionsAvailable(mHasMorePages);
+      emit signalLoadingFinished();
+      return;
+   }
+
+   mRevCache->appendPage(commits);
+
+   // Only the references of the new commits are added, the rest of the graph keeps the ones it has.
+   auto referencesAdded = false;
+
+   for (const auto &commit : commits)
+   {
+      const auto sha = commit.sha();
+      const auto references = mUnloadedReferences.values(sha);
+
+      for (const auto &reference : references)
+         referencesAdded |= mRevCache->insertReference(sha, reference.first, reference.second);
+
+      mUnloadedReferences.remove(sha);
+   }
+
+   if (referencesAdded)
+      mRevCache->publishSnapshot();
+
+   mHasMorePages = success && commits.count() >= mPageSize && !mPagePending.isEmpty();
+
+   emit signalRevisionsPageLoaded(mRevCache->count());
+   emit signalMoreRevisionsAvailable(mHasMorePages);
+}
+
+void GitRepoLoader::fetchMoreRevisions()
+{
+   // The load in progress notifies if there are more pages once it finishes.
+   if (mLocked || mPageRequested)
+      return;
+
+   if (mHasMorePages)
+   {
+      QLog_Info("Git", QString("Loading the next page of revisions after {%1} revisions.").arg(mRevCache->count()));
+
+      // None of the commits reachable from the pending ones is loaded, so the next page is the first part of their
+      // log. They are passed through the standard input since there can be too many for the command line.
+      QByteArray revisions;
+
+      for (const auto &oid : qAsConst(mPagePending))
+         revisions.append(oid.toString().toLatin1()).append('\n');
+
+      requestPage(mPageCmd + QString("--stdin"), revisions);
+   }
+   else
+      emit signalMoreRevisionsAvailable(false);
+}
+
+void GitRepoLoader::requestPrsStatus()
+{
    QScopedPointer<GitConfig> gitConfig(new GitConfig(mGitBase));
    const auto serverUrl = gitConfig->getServerUrl();
 
@@ -200,11 +547,245 @@ void GitRepoLoader::processRevision(QByteArray ba)
 
       emit signalRefreshPRsCache(repoInfo.first, repoInfo.second, serverUrl);
    }
+}
+
+CommitGraphCache::Key GitRepoLoader::getGraphCacheKey() const
+{
+   CommitGraphCache::Key key;
+
+   const auto head = mGitBase->run("git rev-parse --revs-only HEAD");
+   const auto references = mGitBase->run("git show-ref -d");
+
+   if (!head.success || !references.success)
+      return key;
+
+   key.head = head.output.toString().trimmed();
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+   const auto referencesList = references.output.toString().split('\n', Qt::SkipEmptyParts);
+#else
+   const auto referencesList = references.output.toString().split('\n', QString::SkipEmptyParts);
+#endif
+
+   // The annotated tags are replaced by the commit they point to (the ^{} entry that follows them).
+   QMap<QString, QString> tipsByRef;
+
+   for (const auto &reference : referencesList)
+   {
+      auto refName = reference.mid(41);
+
+      if (refName.endsWith("^{}"))
+         refName.chop(3);
+
+      tipsByRef[refName] = reference.left(40);
+   }
+
+   key.tips = tipsByRef.values();
+   key.tips.append(key.head);
+   key.tips.sort();
+   key.tips.removeDuplicates();
+
+   return key;
+}
+
+bool GitRepoLoader::loadFromGraphCache()
+{
+   // The file can't be mapped while it's being replaced.
+   mGraphCacheWrite.waitForFinished();
+
+   CommitGraphCache graphCache(mGitBase->getGitQlientSettingsDir());
+
+   if (!graphCache.open())
+      return false;
+
+   const auto cachedKey = graphCache.key();
+   QList<CommitInfo> missingCommits;
+
+   if (cachedKey != mGraphCacheKey)
+   {
+      auto success = false;
+      missingCommits = requestMissingCommits(cachedKey, success);
+
+      if (!success)
+      {
+         QLog_Info("Git", "The commits cache file is outdated and will be rebuilt.");
+         graphCache.remove();
+         return false;
+      }
+   }
+
+   CommitStore store;
+   GraphRows rows;
+   const auto success = graphCache.read(store, rows);
+
+   graphCache.close();
+
+   if (!success || rows.count() <= 1)
+      return false;
+
+   QLog_Info("Git", QString("Loading {%1} revisions from the commits cache file.").arg(rows.count() - 1));
+
+   requestPrsStatus();
+
+   // The stored graph keeps its lanes. The commits added since it was stored go on top of it, and only the lanes of
+   // the rows below them that change are calculated again.
+   mRevCache->setup(store, rows, cachedKey.head);
+   mRevCache->prependCommits(processWip(), missingCommits);
+
+   loadReferences();
+
+   mRevCache->setConfigurationDone();
+
+   if (cachedKey != mGraphCacheKey)
+      storeGraphCacheLater();
+
+   mLoadedGraphKey = mGraphCacheKey;
+   mLocked = false;
+
+   emit signalLoadingFinished();
+
+   return true;
+}
+
+bool GitRepoLoader::updateLoadedGraph(const CommitGraphCache::Key &loadedKey)
+{
+   if (!loadedKey.isValid() || mRevCache->count() <= 1)
+      return false;
+
+   auto success = false;
+   const auto newCommits = requestMissingCommits(loadedKey, success);
+
+   if (!success)
+      return false;
+
+   QLog_Info("Git", QString("Updating the loaded graph with {%1} new revisions.").arg(newCommits.count()));
+
+   requestPrsStatus();
+
+   // The files of every revision and the rest of the graph are still valid, only the references need to be reloaded.
+   // The new rows, the WIP and the references are published at once by loadReferences, so the GUI never sees the
+   // graph without its references.
+   const auto wipInfo = processWip();
+
+   mRevCache->clearReferences();
+   mRevCache->prependCommits(wipInfo, newCommits);
+
+   loadReferences();
+
+   mRevCache->updateSearchIndex();
+
+   if (loadedKey != mGraphCacheKey)
+      storeGraphCacheLater();
+
+   mLoadedGraphKey = mGraphCacheKey;
+   mLocked = false;
+
+   emit signalLoadingFinished();
+
+   return true;
+}
+
+QList<CommitInfo> GitRepoLoader::requestMissingCommits(const CommitGraphCache::Key &cachedKey, bool &success) const
+{
+   QStringList addedTips;
+   QStringList removedTips;
+
+   for (const auto &tip : mGraphCacheKey.tips)
+   {
+      if (!cachedKey.tips.contains(tip))
+         addedTips.append(tip);
+   }
+
+   for (const auto &tip : cachedKey.tips)
+   {
+      if (!mGraphCacheKey.tips.contains(tip))
+         removedTips.append(tip);
+   }
+
+   success = false;
+
+   // The commits already loaded can't be mixed with commits that have a different format.
+   if (cachedKey.withBodies != mGraphCacheKey.withBodies)
+      return {};
+
+   if (addedTips.count() + cachedKey.tips.count() > MAX_GRAPH_CACHE_TIPS
+       || removedTips.count() + mGraphCacheKey.tips.count() > MAX_GRAPH_CACHE_TIPS)
+   {
+      return {};
+   }
+
+   // The cached commits can only be reused if they are still reachable (no history rewrite or deleted branches).
+   if (!removedTips.isEmpty())
+   {
+      const auto ret = mGitBase->run(QString("git rev-list --count %1 --not %2")
+                                         .arg(removedTips.join(' '), mGraphCacheKey.tips.join(' ')));
+
+      if (!ret.success || ret.output.toString().trimmed() != QString("0"))
+         return {};
+   }
+
+   success = true;
+
+   if (addedTips.isEmpty())
+      return {};
+
+   const auto cmd = QString("git log --date-order --no-color --log-size --parents -z --pretty=format:")
+                        .append(getLogFormat())
+                        .append(QString("%1 --not %2").arg(addedTips.join(' '), cachedKey.tips.join(' ')));
+   const auto ret = mGitBase->run(cmd);
+
+   success = ret.success;
+
+   if (!success)
+      return {};
+
+   auto log = ret.output.toString().toUtf8();
+
+   return processUnsignedLog(log);
+}
+
+void GitRepoLoader::storeGraphCache()
+{
+   if (!mStoreGraphCache || !mGraphCacheKey.isValid())
+      return;
+
+   const auto gitDir = mGitBase->getGitQlientSettingsDir();
+   const auto key = mGraphCacheKey;
+
+   // The snapshot doesn't change once it's published, so it's written from the pool without copying the commits.
+   const auto snapshot = mRevCache->getSnapshot();
+
+   // Only one write runs at a time, and the file is not read while it runs.
+   mGraphCacheWrite.waitForFinished();
+   mGraphCacheWrite = QtConcurrent::run(
+       [gitDir, key, snapshot]() { CommitGraphCache(gitDir).write(key, snapshot->store, snapshot->rows); });
+
+   mGraphCacheOutdated = false;
+   mGraphCacheWritten.start();
+}
+
+void GitRepoLoader::storeGraphCacheLater()
+{
+   // Writing the whole file costs more than the update itself, so the updates are written in groups.
+   mGraphCacheOutdated = mStoreGraphCache && mGraphCacheKey.isValid();
+
+   const auto canWrite = !mGraphCacheWritten.isValid() || mGraphCacheWritten.hasExpired(GRAPH_CACHE_WRITE_INTERVAL);
+
+   if (mGraphCacheOutdated && canWrite)
+      storeGraphCache();
+}
+
+void GitRepoLoader::processRevision(QByteArray ba)
+{
+   QLog_Info("Git", "Revisions received!");
+
+   requestPrsStatus();
 
    QLog_Debug("Git", "Processing revisions...");
 
    emit signalLoadingStarted(1);
 
+   QScopedPointer<GitConfig> gitConfig(new GitConfig(mGitBase));
    const auto ret = gitConfig->getGitValue("log.showSignature");
    const auto showSignature = ret.success ? ret.output.toString().contains("true") : false;
    const auto commits = showSignature ? processSignedLog(ba) : processUnsignedLog(ba);
@@ -216,38 +797,100 @@ void GitRepoLoader::processRevision(QByteArray ba)
 
    mRevCache->setConfigurationDone();
 
+   storeGraphCache();
+
+   mLoadedGraphKey = mGraphCacheKey;
+
+   mLocked = false;
+
+   emit signalLoadingFinished();
+}
+
+void GitRepoLoader::processRevisionChunk(const QByteArray &chunk)
+{
+   mStreamBuffer.append(chunk);
+
+   // Only the complete records are parsed, the last one stays in the buffer until its separator arrives.
+   if (const auto lastSeparator = mStreamBuffer.lastIndexOf('\000'); lastSeparator != -1)
+   {
+      auto records = QByteArray::fromRawData(mStreamBuffer.constData(), lastSeparator);
+      mStreamedCommits.append(processUnsignedLog(records));
+      mStreamBuffer.remove(0, lastSeparator + 1);
+
+      if (mStreamedCommits.count() >= mStreamBatchSize)
+         flushStreamedRevisions();
+   }
+}
+
+void GitRepoLoader::processRevisionStreamEnd(bool success)
+{
+   QLog_Info("Git", QString("Revisions stream finished %1.").arg(success ? "successfully" : "with errors"));
+
+   if (!mStreamBuffer.isEmpty())
+   {
+      mStreamedCommits.append(processUnsignedLog(mStreamBuffer));
+      mStreamBuffer.clear();
+   }
+
+   flushStreamedRevisions();
+
+   loadReferences();
+
+   mRevCache->setConfigurationDone();
+
+   if (success)
+   {
+      storeGraphCache();
+
+      mLoadedGraphKey = mGraphCacheKey;
+   }
+
    mLocked = false;
 
    emit signalLoadingFinished();
 }
 
+void GitRepoLoader::flushStreamedRevisions()
+{
+   if (!mStreamedCommits.isEmpty())
+   {
+      mRevCache->appendCommits(mStreamedCommits);
+      mStreamedCommits.clear();
+      mStreamBatchSize = std::min(mStreamBatchSize * 2, MAX_STREAM_BATCH);
+
+      emit signalRevisionsAppended(mRevCache->count());
+   }
+}
+
 WipRevisionInfo GitRepoLoader::processWip()
 {
    QLog_Debug("Git", QString("Executing processWip."));
 
-   mRevCache->setUntrackedFilesList(getUntrackedFiles());
+   // The untracked files don't depend on HEAD so they are listed while the rest of commands run.
+   auto untrackedFiles = QtConcurrent::run([this]() { return getUntrackedFiles(); });
 
    const auto ret = mGitBase->run("git rev-parse --revs-only HEAD");
 
    if (ret.success)
    {
-      QString diffIndex;
-      QString diffIndexCached;
-
       auto parentSha = ret.output.toString().trimmed();
 
       if (parentSha.isEmpty())
          parentSha = CommitInfo::INIT_SHA;
 
-      const auto ret3 = mGitBase->run(QString("git diff-index %1").arg(parentSha));
-      diffIndex = ret3.success ? ret3.output.toString() : QString();
-
+      const auto diffIndexCmd = QString("git diff-index %1").arg(parentSha);
+      auto diffIndex = QtConcurrent::run([this, diffIndexCmd]() { return mGitBase->run(diffIndexCmd); });
       const auto ret4 = mGitBase->run(QString("git diff-index --cached %1").arg(parentSha));
-      diffIndexCached = ret4.success ? ret4.output.toString() : QString();
+      const auto diffIndexCached = ret4.success ? ret4.output.toString() : QString();
+      const auto ret3 = diffIndex.result();
+
+      mRevCache->setUntrackedFilesList(untrackedFiles.result());
 
-      return { parentSha, diffIndex, diffIndexCached };
+      return { parentSha, ret3.success ? ret3.output.toString() : QString(), diffIndexCached };
    }
 
+   mRevCache->setUntrackedFilesList(untrackedFiles.result());
+
    return {};
 }
 
@@ -279,24 +922,20 @@ QVector<QString> GitRepoLoader::getUntrackedFiles() const
    return ret;
 }
 
-QList<CommitInfo> GitRepoLoader::processUnsignedLog(QByteArray &log)
+QString GitRepoLoader::getLogFormat() const
 {
-   QList<CommitInfo> commits;
-   auto commitsLog = log.split('\000');
-
-   for (auto &commitData : commitsLog)
-   {
-      if (auto commit = parseCommitData(commitData); commit.isValid())
-         commits.append(std::move(commit));
-   }
+   return QString::fromUtf8(mLazyBodies ? GIT_LOG_FORMAT_NO_BODY : GIT_LOG_FORMAT);
+}
 
-   return commits;
+QList<CommitInfo> GitRepoLoader::processUnsignedLog(QByteArray &log) const
+{
+   return setLongLogsLoaded(GitLogParser::parseLog(log));
 }
 
 QList<CommitInfo> GitRepoLoader::processSignedLog(QByteArray &log) const
 {
    auto preProcessedCommits = log.replace('\000', '\n').split('\n');
-   QList<CommitInfo> commits;
+   QVector<QByteArray> records;
    QByteArray commit;
    QByteArray gpg;
    QString gpgKey;
@@ -323,9 +962,7 @@ QList<CommitInfo> GitRepoLoader::processSignedLog(QByteArray &log) const
       {
          if (!commit.isEmpty())
          {
-            if (auto revision = parseCommitData(commit); revision.isValid())
-               commits.append(std::move(revision));
-
+            records.append(commit);
             commit.clear();
          }
          processingCommit = true;
@@ -339,40 +976,21 @@ QList<CommitInfo> GitRepoLoader::processSignedLog(QByteArray &log) const
       }
    }
 
-   return commits;
+   if (!commit.isEmpty())
+      records.append(commit);
+
+   // Splitting the records depends on the GPG lines that precede them, but once split they can be parsed in parallel.
+   return setLongLogsLoaded(GitLogParser::parseRecords(records));
 }
 
-CommitInfo GitRepoLoader::parseCommitData(QByteArray &commitData) const
+QList<CommitInfo> GitRepoLoader::setLongLogsLoaded(QList<CommitInfo> commits) const
 {
-   if (const auto fields = QString::fromUtf8(commitData).split('\n'); fields.count() > 6)
+   // Without bodies in the log the commits are marked so the UI reads them through GitBase::loadCommitBody.
+   if (mLazyBodies)
    {
-      const auto firstField = fields.constFirst();
-      const auto isSigned = !fields.first().isEmpty() && !firstField.contains("log size") ? true : false;
-      auto combinedShas = fields.at(1);
-      auto commitSha = combinedShas.split('X').first();
-      const auto boundary = commitSha[0];
-      const auto sha = commitSha.remove(0, 1);
-      combinedShas = combinedShas.remove(0, sha.size() + 1 + 1).trimmed();
-      QStringList parentsSha;
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-      parentsSha = combinedShas.split(' ', Qt::SkipEmptyParts);
-#else
-      parentsSha = combinedShas.split(' ', QString::SkipEmptyParts);
-#endif
-      const auto committer = fields.at(2);
-      const auto author = fields.at(3);
-      const auto commitDate = QDateTime::fromSecsSinceEpoch(fields.at(4).toInt());
-      const auto shortLog = fields.at(5);
-      QString longLog;
-
-      for (auto i = 6; i < fields.count(); ++i)
-         longLog += fields.at(i) + '\n';
-
-      longLog = longLog.trimmed();
-
-      return CommitInfo { sha,    parentsSha, boundary, committer, commitDate,
-                          author, shortLog,   longLog,  isSigned,  isSigned ? firstField : QString() };
+      for (auto &commit : commits)
+         commit.setLongLogLoaded(false);
    }
 
-   return CommitInfo();
+   return commits;
 }
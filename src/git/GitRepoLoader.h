@@ -25,13 +25,21 @@
 
 #include <GitExecResult.h>
 #include <CommitInfo.h>
+#include <CommitGraphCache.h>
 
+#include <QElapsedTimer>
+#include <QFuture>
 #include <QObject>
+#include <QPointer>
 #include <QSharedPointer>
 #include <QVector>
+#include <QMap>
+#include <QMultiHash>
+#include <QSet>
 
 class GitBase;
 class GitCache;
+class GitStreamProcess;
 struct WipRevisionInfo;
 
 class GitRepoLoader : public QObject
@@ -41,29 +49,75 @@ class GitRepoLoader : public QObject
 signals:
    void signalLoadingStarted(int total);
    void signalLoadingFinished();
+   void signalRevisionsAppended(int totalCommits);
+   void signalRevisionsPageLoaded(int totalCommits);
+   void signalMoreRevisionsAvailable(bool available);
+   void signalLocalBranchDistancesLoaded(const QString &branch);
    void cancelAllProcesses(QPrivateSignal);
    void signalRefreshPRsCache(const QString repoName, const QString &repoOwner, const QString &serverUrl);
 
 public:
    explicit GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<GitCache> cache, QObject *parent = nullptr);
+   ~GitRepoLoader();
    bool loadRepository();
    void updateWipRevision();
    void cancelAll();
    void setShowAll(bool showAll = true) { mShowAll = showAll; }
+   void fetchMoreRevisions();
 
 private:
    bool mShowAll = true;
    bool mLocked = false;
    QSharedPointer<GitBase> mGitBase;
    QSharedPointer<GitCache> mRevCache;
+   QByteArray mStreamBuffer;
+   QList<CommitInfo> mStreamedCommits;
+   int mStreamBatchSize = 0;
+   CommitGraphCache::Key mGraphCacheKey;
+   QMap<QString, QString> mLocalBranchesShas;
+   QMap<QString, QString> mRemoteBranchesShas;
+   CommitGraphCache::Key mLoadedGraphKey;
+   bool mStoreGraphCache = false;
+   QFuture<void> mGraphCacheWrite;
+   QElapsedTimer mGraphCacheWritten;
+   bool mGraphCacheOutdated = false;
+   bool mLazyBodies = false;
+   QPointer<GitStreamProcess> mPageStream;
+   QString mPageCmd;
+   int mPageSize = 0;
+   bool mPageSigned = false;
+   bool mPageRequested = false;
+   bool mHasMorePages = false;
+   // The commits not loaded yet that are parents of the loaded ones or tips of the branches.
+   QSet<CommitOid> mPagePending;
+   QMultiHash<QString, QPair<References::Type, QString>> mUnloadedReferences;
 
    bool configureRepoDirectory();
    void loadReferences();
+   void loadLocalBranchDistances();
    void requestRevisions();
+   void requestRevisionsStream(const QString &cmd);
+   void requestRevisionsPaged(const QString &revisions, bool showSignature);
+   void requestPage(const QString &cmd, const QByteArray &input = QByteArray());
+   void processPageChunk(const QByteArray &chunk);
+   void processPageStreamEnd(bool success);
+   void stopPageStream();
+   void loadPage(const QList<CommitInfo> &commits, bool success);
+   void requestPrsStatus();
+   CommitGraphCache::Key getGraphCacheKey() const;
+   bool loadFromGraphCache();
+   bool updateLoadedGraph(const CommitGraphCache::Key &loadedKey);
+   QList<CommitInfo> requestMissingCommits(const CommitGraphCache::Key &cachedKey, bool &success) const;
+   void storeGraphCache();
+   void storeGraphCacheLater();
    void processRevision(QByteArray ba);
+   void processRevisionChunk(const QByteArray &chunk);
+   void processRevisionStreamEnd(bool success);
+   void flushStreamedRevisions();
    WipRevisionInfo processWip();
    QVector<QString> getUntrackedFiles() const;
-   QList<CommitInfo> processUnsignedLog(QByteArray &log);
+   QString getLogFormat() const;
+   QList<CommitInfo> processUnsignedLog(QByteArray &log) const;
    QList<CommitInfo> processSignedLog(QByteArray &log) const;
-   CommitInfo parseCommitData(QByteArray &commitData) const;
+   QList<CommitInfo> setLongLogsLoaded(QList<CommitInfo> commits) const;
 };
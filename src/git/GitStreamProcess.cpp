@@ -0,0 +1,45 @@
+#include "GitStreamProcess.h"
+
+GitStreamProcess::GitStreamProcess(const QString &workingDir)
+   : AGitProcess(workingDir)
+{
+}
+
+GitExecResult GitStreamProcess::run(const QString &command)
+{
+   return { execute(command), "" };
+}
+
+GitExecResult GitStreamProcess::run(const QString &command, const QByteArray &input)
+{
+   const auto started = execute(command);
+
+   if (started)
+   {
+      write(input);
+      closeWriteChannel();
+   }
+
+   return { started, "" };
+}
+
+void GitStreamProcess::onReadyStandardOutput()
+{
+   if (!mCanceling)
+   {
+      if (const auto chunk = readAllStandardOutput(); !chunk.isEmpty())
+         emit signalDataChunk(chunk);
+   }
+}
+
+void GitStreamProcess::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+   onReadyStandardOutput();
+
+   AGitProcess::onFinished(exitCode, exitStatus);
+
+   if (!mCanceling)
+      emit signalStreamFinished(!mRealError);
+
+   deleteLater();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <AGitProcess.h>
+
+/**
+ * @brief The GitStreamProcess class runs a Git command asynchronously and forwards its standard output as soon as it's
+ * available instead of waiting for the process to finish. It's meant for commands with a huge output (like the log of
+ * the whole repository) that can be processed progressively.
+ */
+class GitStreamProcess final : public AGitProcess
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief Signal triggered every time there is new data in the standard output of the process.
+    *
+    * @param chunk The new data. It can be cut at any point so the receiver must handle partial records.
+    */
+   void signalDataChunk(const QByteArray &chunk);
+   /**
+    * @brief Signal triggered when the process finishes and all the output has been forwarded.
+    *
+    * @param success True if the process finished without errors, otherwise false.
+    */
+   void signalStreamFinished(bool success);
+
+public:
+   explicit GitStreamProcess(const QString &workingDir);
+   GitExecResult run(const QString &command) override;
+   /**
+    * @brief Runs the command writing the input to its standard input, that is closed afterwards.
+    *
+    * @param command The Git command.
+    * @param input The data the command reads from the standard input.
+    * @return GitExecResult Whether the process started.
+    */
+   GitExecResult run(const QString &command, const QByteArray &input);
+
+private:
+   void onReadyStandardOutput() override;
+   void onFinished(int exitCode, QProcess::ExitStatus exitStatus) override;
+};
@@ -2,6 +2,7 @@
 
 #include <CommitHistoryColumns.h>
 #include <CommitInfo.h>
+#include <CommitRow.h>
 #include <GitCache.h>
 #include <GitServerCache.h>
 #include <GitBase.h>
@@ -22,11 +23,15 @@ CommitHistoryModel::CommitHistoryModel(const QSharedPointer<GitCache> &cache, co
    mColumns.insert(CommitHistoryColumns::Log, "Log");
    mColumns.insert(CommitHistoryColumns::Author, "Author");
    mColumns.insert(CommitHistoryColumns::Date, "Date");
+
+   // The display data is built by a worker thread.
+   connect(mCache.data(), &GitCache::signalDisplayDataUpdated, this, &CommitHistoryModel::onDisplayDataUpdated,
+           Qt::QueuedConnection);
 }
 
 int CommitHistoryModel::rowCount(const QModelIndex &parent) const
 {
-   return !parent.isValid() ? mCache->count() : 0;
+   return !parent.isValid() ? mRowCount : 0;
 }
 
 bool CommitHistoryModel::hasChildren(const QModelIndex &parent) const
@@ -42,6 +47,9 @@ QString CommitHistoryModel::sha(int row) const
 void CommitHistoryModel::clear()
 {
    beginResetModel();
+   mRowCount = 0;
+   mCanFetchMore = false;
+   mFetching = false;
    endResetModel();
    emit headerDataChanged(Qt::Horizontal, 0, 5);
 }
@@ -49,10 +57,47 @@ void CommitHistoryModel::clear()
 void CommitHistoryModel::onNewRevisions(int totalCommits)
 {
    beginResetModel();
+   mRowCount = totalCommits;
    endResetModel();
+}
+
+void CommitHistoryModel::onDisplayDataUpdated()
+{
+   if (mRowCount > 0)
+   {
+      const auto column = static_cast<int>(CommitHistoryColumns::Date);
+      emit dataChanged(index(0, column), index(mRowCount - 1, column));
+   }
+}
 
-   beginInsertRows(QModelIndex(), 0, totalCommits - 2);
-   endInsertRows();
+void CommitHistoryModel::onRevisionsAppended(int totalCommits)
+{
+   if (totalCommits > mRowCount)
+   {
+      beginInsertRows(QModelIndex(), mRowCount, totalCommits - 1);
+      mRowCount = totalCommits;
+      endInsertRows();
+   }
+}
+
+bool CommitHistoryModel::canFetchMore(const QModelIndex &parent) const
+{
+   return !parent.isValid() && mCanFetchMore && !mFetching;
+}
+
+void CommitHistoryModel::fetchMore(const QModelIndex &parent)
+{
+   if (canFetchMore(parent))
+   {
+      mFetching = true;
+      emit signalFetchMore();
+   }
+}
+
+void CommitHistoryModel::setCanFetchMore(bool canFetchMore)
+{
+   mCanFetchMore = canFetchMore;
+   mFetching = false;
 }
 
 QVariant CommitHistoryModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -65,7 +110,7 @@ QVariant CommitHistoryModel::headerData(int section, Qt::Orientation orientation
 
 QModelIndex CommitHistoryModel::index(int row, int column, const QModelIndex &) const
 {
-   return row >= 0 && row < mCache->count() ? createIndex(row, column, nullptr) : QModelIndex();
+   return row >= 0 && row < mRowCount ? createIndex(row, column, nullptr) : QModelIndex();
 }
 
 QModelIndex CommitHistoryModel::parent(const QModelIndex &) const
@@ -73,7 +118,7 @@ QModelIndex CommitHistoryModel::parent(const QModelIndex &) const
    return QModelIndex();
 }
 
-QVariant CommitHistoryModel::getToolTipData(const CommitInfo &r) const
+QVariant CommitHistoryModel::getToolTipData(const CommitRow &r) const
 {
    QString auxMessage;
    const auto sha = r.sha();
@@ -97,14 +142,14 @@ QVariant CommitHistoryModel::getToolTipData(const CommitInfo &r) const
       auxMessage.append(QString("<p><b>Tags: </b>%1</p>").arg(tags.join(",")));
 
    QDateTime d;
-   d.setSecsSinceEpoch(r.authorDate().toUInt());
+   d.setSecsSinceEpoch(r.authorDate());
 
    QLocale locale;
 
-   auto tooltip = sha == CommitInfo::ZERO_SHA
+   auto tooltip = r.isWip()
        ? QString()
        : QString("<p>%1 - %2</p><p>%3</p>%4%5")
-             .arg(r.author().split("<").first(), d.toString(locale.dateTimeFormat(QLocale::ShortFormat)), sha,
+             .arg(r.shortAuthor(), d.toString(locale.dateTimeFormat(QLocale::ShortFormat)), sha,
                   !auxMessage.isEmpty() ? QString("<p>%1</p>").arg(auxMessage) : "",
                   r.isSigned() ? QString::fromUtf8("<p>Commit signed!</p><p> GPG key: %1</p>").arg(r.getGpgKey()) : "");
 
@@ -117,7 +162,7 @@ QVariant CommitHistoryModel::getToolTipData(const CommitInfo &r) const
    return tooltip;
 }
 
-QVariant CommitHistoryModel::getDisplayData(const CommitInfo &rev, int column) const
+QVariant CommitHistoryModel::getDisplayData(const CommitRow &rev, int column) const
 {
    switch (static_cast<CommitHistoryColumns>(column))
    {
@@ -127,13 +172,10 @@ QVariant CommitHistoryModel::getDisplayData(const CommitInfo &rev, int column) c
       }
       case CommitHistoryColumns::Log:
          return rev.shortLog();
-      case CommitHistoryColumns::Author: {
-         const auto author = rev.author().split("<").first();
-         return author;
-      }
-      case CommitHistoryColumns::Date: {
-         return QDateTime::fromSecsSinceEpoch(rev.authorDate().toUInt()).toString("dd MMM yyyy hh:mm");
-      }
+      case CommitHistoryColumns::Author:
+         return rev.shortAuthor();
+      case CommitHistoryColumns::Date:
+         return rev.dateText();
       default:
          return QVariant();
    }
@@ -141,10 +183,24 @@ QVariant CommitHistoryModel::getDisplayData(const CommitInfo &rev, int column) c
 
 QVariant CommitHistoryModel::data(const QModelIndex &index, int role) const
 {
-   if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ToolTipRole))
+   if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ToolTipRole && role < TimeRole))
       return QVariant();
 
-   const auto r = mCache->getCommitInfoByRow(index.row());
+   const auto r = mCache->getCommitRow(index.row());
+
+   switch (role)
+   {
+      case TimeRole:
+         return r.timeText();
+      case LongDateRole:
+         return r.longDateText();
+      case DayRole:
+         return r.day();
+      case SameDayRole:
+         return r.isSameDayAsPrevious();
+      default:
+         break;
+   }
 
    if (role == Qt::ToolTipRole)
       return getToolTipData(r);
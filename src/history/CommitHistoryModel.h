@@ -28,7 +28,7 @@
 
 class GitCache;
 class GitBase;
-class CommitInfo;
+class CommitRow;
 class GitServerCache;
 enum class CommitHistoryColumns;
 
@@ -41,7 +41,25 @@ enum class CommitHistoryColumns;
 class CommitHistoryModel : public QAbstractItemModel
 {
    Q_OBJECT
+
+signals:
+   /**
+    * @brief Signal triggered when the view needs more rows and the history is loaded in pages.
+    */
+   void signalFetchMore();
+
 public:
+   /**
+    * @brief Custom roles of the Date column, so the view doesn't parse the dates to decide how to show them.
+    */
+   enum Role
+   {
+      TimeRole = Qt::UserRole + 1, /*!< The time as "hh:mm". */
+      LongDateRole, /*!< The date as "dd MMM yyyy - hh:mm". */
+      DayRole, /*!< The day of the date as a Julian day. */
+      SameDayRole /*!< True if the commit is from the same day as the one in the previous row of the graph. */
+   };
+
    /**
     * @brief The default constructor.
     *
@@ -119,12 +137,38 @@ public:
     * @return int The number of columns.
     */
    int columnCount(const QModelIndex &) const override { return mColumns.count(); }
+   /**
+    * @brief Returns if there are more revisions to load and no page is being loaded.
+    *
+    * @param parent The parent index.
+    * @return bool True if the view can request more rows, otherwise false.
+    */
+   bool canFetchMore(const QModelIndex &parent) const override;
+   /**
+    * @brief Requests the next page of revisions. The rows are added when it's loaded.
+    *
+    * @param parent The parent index.
+    */
+   void fetchMore(const QModelIndex &parent) override;
+   /**
+    * @brief Sets if the history has more revisions that can be loaded. It also ends the page request in progress.
+    *
+    * @param canFetchMore True if there are more revisions, otherwise false.
+    */
+   void setCanFetchMore(bool canFetchMore);
    /**
     * @brief Resets the model when new revisions are available.
     *
     * @param totalCommits The total of new revisions.
     */
    void onNewRevisions(int totalCommits);
+   /**
+    * @brief Adds the rows of the revisions appended to the cache while the history is still loading. It doesn't reset
+    * the model so the selection and the scroll position are kept.
+    *
+    * @param totalCommits The total of revisions in the cache.
+    */
+   void onRevisionsAppended(int totalCommits);
    /*!
     * \brief Gets the number of columns in the model.
     * \return The number of columns.
@@ -136,6 +180,9 @@ private:
    QSharedPointer<GitBase> mGit;
    QSharedPointer<GitServerCache> mGitServerCache;
    QMap<CommitHistoryColumns, QString> mColumns;
+   int mRowCount = 0;
+   bool mCanFetchMore = false;
+   bool mFetching = false;
 
    /**
     * @brief Returns the tool tip data.
@@ -143,7 +190,7 @@ private:
     * @param r The commit to generate the tooltip data.
     * @return QVariant The tool tip data.
     */
-   QVariant getToolTipData(const CommitInfo &r) const;
+   QVariant getToolTipData(const CommitRow &r) const;
    /**
     * @brief Returns the data that will be display for every \p column.
     *
@@ -151,5 +198,10 @@ private:
     * @param column The column where the data will be shown.
     * @return QVariant The data to be shown.
     */
-   QVariant getDisplayData(const CommitInfo &rev, int column) const;
+   QVariant getDisplayData(const CommitRow &rev, int column) const;
+   /**
+    * @brief Notifies the views that the dates of the rows changed. The rows painted before the display data was built
+    * don't know which of them start a new day.
+    */
+   void onDisplayDataUpdated();
 };
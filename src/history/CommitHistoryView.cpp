@@ -4,6 +4,7 @@
 #include <CommitHistoryColumns.h>
 #include <CommitHistoryContextMenu.h>
 #include <ShaFilterProxyModel.h>
+#include <HistoryFilterEngine.h>
 #include <CommitInfo.h>
 #include <GitCache.h>
 #include <GitConfig.h>
@@ -12,10 +13,14 @@
 
 #include <QHeaderView>
 #include <QDateTime>
+#include <QScrollBar>
 
 #include <QLogger.h>
 using namespace QLogger;
 
+// When the history is loaded in pages, the next one is requested this number of screens before reaching the end.
+static const int FETCH_MORE_SCREENS = 3;
+
 CommitHistoryView::CommitHistoryView(const QSharedPointer<GitCache> &cache, const QSharedPointer<GitBase> &git,
                                      const QSharedPointer<GitServerCache> &gitServerCache, QWidget *parent)
    : QTreeView(parent)
@@ -36,6 +41,16 @@ CommitHistoryView::CommitHistoryView(const QSharedPointer<GitCache> &cache, cons
 
    connect(mCache.get(), &GitCache::signalCacheUpdated, this, &CommitHistoryView::refreshView);
 
+   connect(verticalScrollBar(), &QScrollBar::valueChanged, this, [this](int value) {
+      const auto scrollBar = verticalScrollBar();
+
+      if (model() && value >= scrollBar->maximum() - scrollBar->pageStep() * FETCH_MORE_SCREENS
+          && model()->canFetchMore(QModelIndex()))
+      {
+         model()->fetchMore(QModelIndex());
+      }
+   });
+
    connect(this, &CommitHistoryView::doubleClicked, this, [this](const QModelIndex &index) {
       if (mCommitHistoryModel)
       {
@@ -76,15 +91,79 @@ void CommitHistoryView::filterBySha(const QStringList &shaList)
    }
    else
    {
-      mProxyModel = new ShaFilterProxyModel(this);
-      mProxyModel->setSourceModel(mCommitHistoryModel);
+      mProxyModel = new ShaFilterProxyModel(mCache, this);
       mProxyModel->setAcceptedSha(shaList);
+      mProxyModel->setSourceModel(mCommitHistoryModel);
       setModel(mProxyModel);
    }
 
    setupGeometry();
 }
 
+void CommitHistoryView::filterByCriteria(const HistoryFilter &filter, bool userRequested)
+{
+   if (!mFilterEngine)
+   {
+      mFilterEngine = new HistoryFilterEngine(mCache, this);
+      connect(mFilterEngine, &HistoryFilterEngine::signalRowsFound, this, [this](const QVector<int> &rows) {
+         if (mProxyModel)
+            mProxyModel->addAcceptedRows(rows);
+      });
+      connect(mFilterEngine, &HistoryFilterEngine::signalFinished, this, [this](int matches) {
+         if (mFilterRequested)
+         {
+            mFilterRequested = false;
+            emit signalFilterFinished(matches);
+         }
+      });
+   }
+
+   // A query of the user that is evaluated again before it finishes still tells the user when it's done.
+   mFilterRequested = userRequested || (mFilterRequested && mFilterEngine->isRunning());
+   mFilter = filter;
+   mIsFiltering = true;
+
+   if (!mProxyModel)
+   {
+      mProxyModel = new ShaFilterProxyModel(mCache, this);
+      mProxyModel->setSourceModel(mCommitHistoryModel);
+      mProxyModel->setAcceptedRows({});
+      setModel(mProxyModel);
+   }
+   else
+      mProxyModel->setAcceptedRows({});
+
+   connect(mProxyModel->sourceModel(), &QAbstractItemModel::modelReset, this, &CommitHistoryView::onSourceReset,
+           Qt::UniqueConnection);
+
+   mFilterEngine->start(mFilter);
+}
+
+void CommitHistoryView::onSourceReset()
+{
+   if (hasCriteriaFilter())
+      filterByCriteria(mFilter, false);
+}
+
+void CommitHistoryView::clearFilter()
+{
+   if (mFilterEngine)
+      mFilterEngine->cancel();
+
+   mFilter = HistoryFilter();
+   mFilterRequested = false;
+   mIsFiltering = false;
+
+   if (mProxyModel)
+   {
+      const auto sourceModel = mProxyModel->sourceModel();
+
+      setModel(sourceModel);
+      mProxyModel->deleteLater();
+      mProxyModel = nullptr;
+   }
+}
+
 CommitHistoryView::~CommitHistoryView()
 {
    GitQlientSettings s;
@@ -23,9 +23,12 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <HistoryFilter.h>
+
 #include <QTreeView>
 
 class GitCache;
+class HistoryFilterEngine;
 class GitBase;
 class CommitHistoryModel;
 class ShaFilterProxyModel;
@@ -86,6 +89,13 @@ signals:
     * @param pr The pull request number to show.
     */
    void showPrDetailedView(int pr);
+   /**
+    * @brief Signal triggered when the filter started by the user with @ref filterByCriteria has checked all the
+    * history. It's not triggered when the filter is evaluated again because the history changed.
+    *
+    * @param matches The number of commits shown.
+    */
+   void signalFilterFinished(int matches);
 
 public:
    /**
@@ -120,6 +130,22 @@ public:
     * @param shaList List of SHA to pass to the filter.
     */
    void filterBySha(const QStringList &shaList);
+   /**
+    * @brief Filters the view by the criteria. The commits are evaluated in the background and shown as they are
+    * found. A new call cancels the previous one.
+    *
+    * @param filter The criteria of the filter.
+    * @param userRequested Whether the user started the filter, so @ref signalFilterFinished is triggered.
+    */
+   void filterByCriteria(const HistoryFilter &filter, bool userRequested = true);
+   /**
+    * @brief Removes the filter set with @ref filterByCriteria and shows all the history again.
+    */
+   void clearFilter();
+   /**
+    * @brief Tells if the view is filtered by criteria.
+    */
+   bool hasCriteriaFilter() const { return !mFilter.isEmpty(); }
    /**
     * @brief Activates/deactivates filtering in the view.
     *
@@ -164,7 +190,15 @@ private:
    ShaFilterProxyModel *mProxyModel = nullptr;
    bool mIsFiltering = false;
    QString mCurrentSha;
+   HistoryFilterEngine *mFilterEngine = nullptr;
+   HistoryFilter mFilter;
+   bool mFilterRequested = false;
 
+   /**
+    * @brief Evaluates the criteria filter again when the history is reset. The filter keeps rows of the history, that
+    * can belong to other commits after a reload even if their number doesn't change.
+    */
+   void onSourceReset();
    /**
     * @brief Shows the context menu for the CommitHistoryView.
     *
@@ -0,0 +1,100 @@
+#include "HistoryFilterEngine.h"
+
+#include <GitCache.h>
+
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+namespace
+{
+// Small enough to show the first results soon, big enough to not flood the GUI thread with updates.
+const int CHUNK_ROWS = 4096;
+}
+
+HistoryFilterEngine::HistoryFilterEngine(const QSharedPointer<GitCache> &cache, QObject *parent)
+   : QObject(parent)
+   , mCache(cache)
+{
+}
+
+HistoryFilterEngine::~HistoryFilterEngine()
+{
+   cancel();
+   mPool.waitForDone();
+}
+
+void HistoryFilterEngine::start(const HistoryFilter &filter)
+{
+   cancel();
+
+   // All the steps of the query work on the same graph, even if the loader publishes a new one meanwhile.
+   const auto queryId = ++mQueryId;
+   const auto canceled = std::make_shared<std::atomic_bool>(false);
+   const auto snapshot = mCache->getSnapshot();
+   const auto rowCount = snapshot->rows.count();
+
+   mCanceled = canceled;
+   mMatches = 0;
+   mPendingChunks = (rowCount + CHUNK_ROWS - 1) / CHUNK_ROWS;
+
+   QLog_Debug("UI", QString("Filtering {%1} rows in {%2} chunks.").arg(rowCount).arg(mPendingChunks));
+
+   if (mPendingChunks == 0)
+   {
+      emit signalFinished(0);
+      return;
+   }
+
+   // Resolving the references walks the graph, so it's done in the pool as well. The chunks are queued once it's done.
+   QtConcurrent::run(&mPool, [this, snapshot, filter, canceled, queryId, rowCount]() {
+      if (*canceled)
+         return;
+
+      const auto resolved
+          = std::make_shared<const ResolvedHistoryFilter>(GitCache::resolveFilter(*snapshot, filter));
+
+      for (auto firstRow = 0; firstRow < rowCount && !*canceled; firstRow += CHUNK_ROWS)
+      {
+         QtConcurrent::run(&mPool, [this, snapshot, resolved, canceled, queryId, firstRow]() {
+            if (*canceled)
+               return;
+
+            const auto rows
+                = GitCache::filterRows(*snapshot, *resolved, firstRow, firstRow + CHUNK_ROWS, *canceled);
+
+            // The engine waits for the pool before being destroyed, so it's alive when the call is queued.
+            QMetaObject::invokeMethod(
+                this, [this, queryId, rows]() { onChunkDone(queryId, rows); }, Qt::QueuedConnection);
+         });
+      }
+   });
+}
+
+void HistoryFilterEngine::cancel()
+{
+   if (mCanceled)
+      *mCanceled = true;
+
+   mCanceled.reset();
+   mPendingChunks = 0;
+}
+
+void HistoryFilterEngine::onChunkDone(int queryId, const QVector<int> &rows)
+{
+   if (queryId != mQueryId || mPendingChunks == 0)
+      return;
+
+   mMatches += rows.count();
+
+   if (!rows.isEmpty())
+      emit signalRowsFound(rows);
+
+   if (--mPendingChunks == 0)
+   {
+      mCanceled.reset();
+      emit signalFinished(mMatches);
+   }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <HistoryFilter.h>
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+class GitCache;
+
+/**
+ * @brief The HistoryFilterEngine class evaluates a @ref HistoryFilter over the history in a pool of threads. The rows
+ * are split in chunks that are checked in parallel, and the rows found in every chunk are sent as soon as the chunk
+ * is done, so the view can show them before the whole history has been checked. The query works on the snapshot of
+ * the graph taken when it starts.
+ *
+ * Only one query runs at a time. Starting a new one cancels the previous, and the results it still sends are dropped.
+ *
+ * @class HistoryFilterEngine HistoryFilterEngine.h "HistoryFilterEngine.h"
+ */
+class HistoryFilterEngine : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief Signal triggered when a chunk of the history has been checked.
+    *
+    * @param rows The rows of the chunk that match the filter, sorted.
+    */
+   void signalRowsFound(const QVector<int> &rows);
+   /**
+    * @brief Signal triggered when all the history has been checked.
+    *
+    * @param matches The number of rows that match the filter.
+    */
+   void signalFinished(int matches);
+
+public:
+   /**
+    * @brief Default constructor.
+    *
+    * @param cache The internal cache for the current repository.
+    * @param parent The parent object if needed.
+    */
+   explicit HistoryFilterEngine(const QSharedPointer<GitCache> &cache, QObject *parent = nullptr);
+   /**
+    * @brief Destructor. It cancels the query and waits for the threads.
+    */
+   ~HistoryFilterEngine() override;
+
+   /**
+    * @brief Starts a query and cancels the previous one.
+    *
+    * @param filter The filter to evaluate.
+    */
+   void start(const HistoryFilter &filter);
+   /**
+    * @brief Cancels the query that is running, if any.
+    */
+   void cancel();
+   /**
+    * @brief Tells if a query is running.
+    */
+   bool isRunning() const { return mPendingChunks > 0; }
+
+private:
+   QSharedPointer<GitCache> mCache;
+   QThreadPool mPool;
+   std::shared_ptr<std::atomic_bool> mCanceled;
+   int mQueryId = 0;
+   int mPendingChunks = 0;
+   int mMatches = 0;
+
+   /**
+    * @brief Receives the results of a chunk in the GUI thread.
+    *
+    * @param queryId The query the chunk belongs to.
+    * @param rows The rows found.
+    */
+   void onChunkDone(int queryId, const QVector<int> &rows);
+};
@@ -0,0 +1,51 @@
+#include "LaneGlyphAtlas.h"
+
+#include <GitQlientStyles.h>
+
+namespace
+{
+// Every combination fits many times, the limit only protects from changing the row height or the screen many times.
+const int MAX_GLYPHS = 4096;
+}
+
+bool LaneGlyphAtlas::find(const Key &key, QPixmap &glyph)
+{
+   if (const auto colorsVersion = GitQlientStyles::getColorsVersion(); colorsVersion != mColorsVersion)
+   {
+      mGlyphs.clear();
+      mColorsVersion = colorsVersion;
+      return false;
+   }
+
+   const auto iter = mGlyphs.constFind(hash(key));
+
+   if (iter == mGlyphs.constEnd())
+      return false;
+
+   glyph = iter.value();
+
+   return true;
+}
+
+void LaneGlyphAtlas::insert(const Key &key, const QPixmap &glyph)
+{
+   if (mGlyphs.count() >= MAX_GLYPHS)
+      mGlyphs.clear();
+
+   mGlyphs.insert(hash(key), glyph);
+}
+
+quint64 LaneGlyphAtlas::hash(const Key &key)
+{
+   // The fields are packed in the bits of the key: the colors are indices of the branch colors.
+   auto packed = static_cast<quint64>(key.type);
+   packed = (packed << 8) | static_cast<quint8>(key.color);
+   packed = (packed << 8) | static_cast<quint8>(key.mergeColor);
+   packed = (packed << 1) | (key.headPresent ? 1 : 0);
+   packed = (packed << 1) | (key.hasChilds ? 1 : 0);
+   packed = (packed << 1) | (key.overflow ? 1 : 0);
+   packed = (packed << 16) | static_cast<quint16>(key.rowHeight);
+   packed = (packed << 16) | static_cast<quint16>(qRound(key.devicePixelRatio * 100));
+
+   return packed;
+}
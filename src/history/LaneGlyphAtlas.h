@@ -0,0 +1,91 @@
+#pragma once
+
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <LaneType.h>
+
+#include <QHash>
+#include <QPixmap>
+
+/**
+ * @brief The LaneGlyphAtlas class keeps the lanes of the graph already painted into pixmaps. A graph has a small set
+ * of different lanes (type, colors and a couple of flags), so once they are painted the rows are drawn by copying
+ * them instead of painting paths.
+ *
+ * The glyphs are painted for a row height and a device pixel ratio, that are part of the key. All the glyphs are
+ * discarded when the colors of GitQlient change.
+ *
+ * @class LaneGlyphAtlas LaneGlyphAtlas.h "LaneGlyphAtlas.h"
+ */
+class LaneGlyphAtlas
+{
+public:
+   /**
+    * @brief The space that the glyphs have at both sides of the lane, since the lines and arcs overflow it.
+    */
+   static constexpr int MARGIN = 4;
+
+   /**
+    * @brief Everything that changes how a lane is painted.
+    */
+   struct Key
+   {
+      LaneType type = LaneType::EMPTY;
+      int color = 0;
+      int mergeColor = 0;
+      bool headPresent = false;
+      bool hasChilds = true;
+      // The glyph that replaces the lanes beyond the maximum. The type and colors are not used.
+      bool overflow = false;
+      int rowHeight = 0;
+      qreal devicePixelRatio = 1.0;
+   };
+
+   /**
+    * @brief Returns the glyph of the key.
+    *
+    * @param key The key.
+    * @param glyph Output with the glyph if it was found.
+    * @return True if the glyph is in the atlas.
+    */
+   bool find(const Key &key, QPixmap &glyph);
+   /**
+    * @brief Adds a glyph to the atlas.
+    *
+    * @param key The key.
+    * @param glyph The glyph. It's @ref MARGIN pixels wider than the lane at both sides.
+    */
+   void insert(const Key &key, const QPixmap &glyph);
+   /**
+    * @brief Removes all the glyphs.
+    */
+   void clear() { mGlyphs.clear(); }
+
+private:
+   QHash<quint64, QPixmap> mGlyphs;
+   int mColorsVersion = -1;
+
+   static quint64 hash(const Key &key);
+};
@@ -1,22 +1,27 @@
 ﻿#include "RepositoryViewDelegate.h"
 
 #include <GitServerCache.h>
+#include <GitQlientSettings.h>
 #include <GitQlientStyles.h>
 #include <GitLocal.h>
 #include <Lane.h>
 #include <LaneType.h>
 #include <CommitInfo.h>
+#include <CommitRow.h>
 #include <CommitHistoryColumns.h>
 #include <CommitHistoryView.h>
 #include <CommitHistoryModel.h>
+#include <ShaFilterProxyModel.h>
 #include <GitCache.h>
 #include <GitBase.h>
 #include <PullRequest.h>
 
-#include <QSortFilterProxyModel>
+#include <QAbstractProxyModel>
 #include <QPainter>
 #include <QPainterPath>
+#include <QtMath>
 #include <QEvent>
+#include <QMouseEvent>
 #include <QDesktopServices>
 #include <QUrl>
 #include <QToolTip>
@@ -26,6 +31,8 @@
 using namespace GitServer;
 
 static const int MIN_VIEW_WIDTH_PX = 480;
+static const int DEFAULT_MAX_LANES = 40;
+static const int MIN_MAX_LANES = 2;
 
 RepositoryViewDelegate::RepositoryViewDelegate(const QSharedPointer<GitCache> &cache,
                                                const QSharedPointer<GitBase> &git,
@@ -36,6 +43,13 @@ RepositoryViewDelegate::RepositoryViewDelegate(const QSharedPointer<GitCache> &c
    , mGitServerCache(gitServerCache)
    , mView(view)
 {
+   GitQlientSettings settings;
+   setMaxLanes(settings.localValue(mGit->getGitQlientSettingsDir(), "MaxGraphLanes", DEFAULT_MAX_LANES).toInt());
+}
+
+void RepositoryViewDelegate::setMaxLanes(int maxLanes)
+{
+   mMaxLanes = qMax(maxLanes, MIN_MAX_LANES);
 }
 
 void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt, const QModelIndex &index) const
@@ -51,16 +65,16 @@ void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
       p->fillRect(newOpt.rect, GitQlientStyles::getGraphHoverColor());
 
    const auto row = mView->hasActiveFilter()
-       ? dynamic_cast<QSortFilterProxyModel *>(mView->model())->mapToSource(index).row()
+       ? dynamic_cast<QAbstractProxyModel *>(mView->model())->mapToSource(index).row()
        : index.row();
 
-   const auto commit = mCache->getCommitInfoByRow(row);
+   const auto commit = mCache->getCommitRow(row);
 
-   if (commit.sha().isEmpty())
+   if (!commit.isValid())
       return;
 
    if (index.column() == static_cast<int>(CommitHistoryColumns::Graph))
-      paintGraph(p, newOpt, commit);
+      paintGraph(p, newOpt, index, commit);
    else if (index.column() == static_cast<int>(CommitHistoryColumns::Log))
       paintLog(p, newOpt, commit, index.data().toString());
    else
@@ -75,13 +89,13 @@ void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
       if (index.column() == static_cast<int>(CommitHistoryColumns::Date))
       {
          textalignment = QTextOption(Qt::AlignRight | Qt::AlignVCenter);
-         const auto prev = QDateTime::fromString(mView->indexAbove(index).data().toString(), "dd MMM yyyy hh:mm");
-         const auto current = QDateTime::fromString(text, "dd MMM yyyy hh:mm");
 
-         if (current.date() == prev.date())
-            text = current.toString("hh:mm");
-         else
-            text = current.toString("dd MMM yyyy - hh:mm");
+         // The previous row of the graph is only the one above when the view is not filtered.
+         const auto sameDay = mView->hasActiveFilter()
+             ? index.data(CommitHistoryModel::DayRole) == mView->indexAbove(index).data(CommitHistoryModel::DayRole)
+             : index.data(CommitHistoryModel::SameDayRole).toBool();
+
+         text = index.data(sameDay ? CommitHistoryModel::TimeRole : CommitHistoryModel::LongDateRole).toString();
 
          newOpt.rect.setWidth(newOpt.rect.width() - 5);
       }
@@ -137,30 +151,53 @@ bool RepositoryViewDelegate::editorEvent(QEvent *event, QAbstractItemModel *mode
       mColumnPressed = cursorColumn;
       return true;
    }
-   else if (event->type() == QEvent::MouseButtonRelease && cursorColumn == index.column() && mColumnPressed != -1)
+   else if (event->type() == QEvent::MouseButtonRelease && cursorColumn == index.column())
    {
-      if (cursorColumn == static_cast<int>(CommitHistoryColumns::Sha))
+      const auto columnPressed = mColumnPressed;
+
+      mColumnPressed = -1;
+
+      if (columnPressed == static_cast<int>(CommitHistoryColumns::Sha)
+          && cursorColumn == static_cast<int>(CommitHistoryColumns::Sha))
       {
          QApplication::clipboard()->setText(index.data().toString());
          QToolTip::showText(QCursor::pos(), tr("Copied!"), mView);
+         return true;
       }
 
-      mColumnPressed = -1;
-      return true;
+      if (cursorColumn == static_cast<int>(CommitHistoryColumns::Graph))
+      {
+         // The overflow glyph is in the last slot of the rows with more lanes than the maximum. Clicking the same slot
+         // when all the lanes of the row are shown folds them again.
+         const auto x = static_cast<QMouseEvent *>(event)->pos().x() - option.rect.x();
+
+         if (x >= 0 && x / LANE_WIDTH == mMaxLanes - 1 && getLanesCount(index) > mMaxLanes)
+         {
+            const auto sha = index.sibling(index.row(), static_cast<int>(CommitHistoryColumns::Sha)).data().toString();
+
+            if (mExpandedShas.contains(sha))
+               mExpandedShas.remove(sha);
+            else
+               mExpandedShas.insert(sha);
+
+            mView->update(index);
+            return true;
+         }
+      }
    }
 
    return QStyledItemDelegate::editorEvent(event, model, option, index);
 }
 
 void RepositoryViewDelegate::paintGraphLane(QPainter *p, const Lane &lane, bool laneHeadPresent, int x1, int x2,
-                                            const QColor &col, const QColor &activeCol, const QColor &mergeColor,
-                                            bool isWip, bool hasChilds) const
+                                            int rowHeight, const QColor &col, const QColor &activeCol,
+                                            const QColor &mergeColor, bool isWip, bool hasChilds) const
 {
    const auto padding = 2;
    x1 += padding;
    x2 += padding;
 
-   const auto h = ROW_HEIGHT / 2;
+   const auto h = rowHeight / 2;
    const auto m = (x1 + x2) / 2;
    const auto r = (x2 - x1) * 1 / 3;
    const auto spanAngle = 90 * 16;
@@ -299,8 +336,51 @@ void RepositoryViewDelegate::paintGraphLane(QPainter *p, const Lane &lane, bool
    }
 }
 
-QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const CommitInfo &commit, int currentLaneIndex,
-                                             const QColor &defaultColor, bool &isSet) const
+void RepositoryViewDelegate::paintGraphGlyph(QPainter *p, const LaneGlyphAtlas::Key &key, int x1) const
+{
+   QPixmap glyph;
+
+   if (!mGlyphAtlas.find(key, glyph))
+   {
+      const auto width = LANE_WIDTH + 2 * LaneGlyphAtlas::MARGIN;
+
+      glyph = QPixmap(qCeil(width * key.devicePixelRatio), qCeil(key.rowHeight * key.devicePixelRatio));
+      glyph.setDevicePixelRatio(key.devicePixelRatio);
+      glyph.fill(Qt::transparent);
+
+      QPainter painter(&glyph);
+      painter.setRenderHints(QPainter::Antialiasing);
+
+      if (key.overflow)
+      {
+         // Three dots in the middle of the lane.
+         const auto x = LaneGlyphAtlas::MARGIN + LANE_WIDTH / 2;
+         const auto y = key.rowHeight / 2;
+
+         painter.setPen(Qt::NoPen);
+         painter.setBrush(GitQlientStyles::getTextColor());
+
+         for (auto dy : { -6, 0, 6 })
+            painter.drawEllipse(QPoint(x, y + dy), 2, 2);
+      }
+      else
+      {
+         const auto color = GitQlientStyles::getBranchColorAt(key.color);
+         paintGraphLane(&painter, key.type, key.headPresent, LaneGlyphAtlas::MARGIN,
+                        LaneGlyphAtlas::MARGIN + LANE_WIDTH, key.rowHeight, color, color,
+                        GitQlientStyles::getBranchColorAt(key.mergeColor), false, key.hasChilds);
+      }
+
+      painter.end();
+
+      mGlyphAtlas.insert(key, glyph);
+   }
+
+   p->drawPixmap(x1 - LaneGlyphAtlas::MARGIN, 0, glyph);
+}
+
+int RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const LaneRow &lanes, int currentLaneIndex,
+                                          int defaultColor, bool &isSet) const
 {
    auto mergeColor = defaultColor;
    //= GitQlientStyles::getBranchColorAt((commit.getLanesCount() - 1) % GitQlientStyles::getTotalBranchColors());
@@ -320,9 +400,9 @@ QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const Comm
       case LaneType::JOIN_L:
          for (auto laneCount = 0; laneCount < currentLaneIndex; ++laneCount)
          {
-            if (commit.getLane(laneCount).equals(LaneType::JOIN_L))
+            if (lanes.at(laneCount).equals(LaneType::JOIN_L))
             {
-               mergeColor = GitQlientStyles::getBranchColorAt(laneCount % GitQlientStyles::getTotalBranchColors());
+               mergeColor = laneCount % GitQlientStyles::getTotalBranchColors();
                isSet = true;
                break;
             }
@@ -335,85 +415,140 @@ QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const Comm
    return mergeColor;
 }
 
-void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem &opt, const CommitInfo &commit) const
+void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem &opt, const QModelIndex &index,
+                                        const CommitRow &commit) const
 {
    p->save();
    p->setClipRect(opt.rect, Qt::IntersectClip);
    p->translate(opt.rect.topLeft());
 
+   // The lanes of the commits are drawn from the atlas. Only the WIP is painted every time, since it depends on the
+   // local changes.
+   LaneGlyphAtlas::Key key;
+   key.rowHeight = opt.rect.height();
+   key.devicePixelRatio = p->device()->devicePixelRatioF();
+   key.hasChilds = commit.hasChilds();
+
+   const auto showAll = !mExpandedShas.isEmpty() && mExpandedShas.contains(commit.sha());
+
    if (mView->hasActiveFilter())
+   {
+      // The filtered views have the lanes calculated only with the commits they show. Until they are ready, the
+      // commits are painted alone.
+      const auto proxy = qobject_cast<const ShaFilterProxyModel *>(index.model());
+      LaneRow lanes;
+
+      if (proxy && proxy->getLanes(index.row(), lanes, key.hasChilds))
+         paintGraphLanes(p, key, lanes, showAll);
+      else
+      {
+         key.type = LaneType::ACTIVE;
+         paintGraphGlyph(p, key, 0);
+      }
+   }
+   else if (commit.isWip())
    {
       const auto activeColor = GitQlientStyles::getBranchColorAt(0);
-      paintGraphLane(p, LaneType::ACTIVE, false, 0, LANE_WIDTH, activeColor, activeColor, activeColor, false,
-                     commit.hasChilds());
+      QColor color = activeColor;
+
+      if (mCache->pendingLocalChanges())
+         color = GitQlientStyles::getGitQlientOrange();
+
+      paintGraphLane(p, LaneType::BRANCH, false, 0, LANE_WIDTH, opt.rect.height(), color, activeColor, activeColor,
+                     true, commit.parentsCount() != 0);
    }
    else
    {
-      if (commit.sha() == CommitInfo::ZERO_SHA)
-      {
-         const auto activeColor = GitQlientStyles::getBranchColorAt(0);
-         QColor color = activeColor;
+      // The lanes are decoded once from the packed buffer of the cache.
+      paintGraphLanes(p, key, commit.getLanes(), showAll);
+   }
 
-         if (mCache->pendingLocalChanges())
-            color = GitQlientStyles::getGitQlientOrange();
+   p->restore();
+}
 
-         paintGraphLane(p, LaneType::BRANCH, false, 0, LANE_WIDTH, color, activeColor, activeColor, true,
-                        commit.parentsCount() != 0);
-      }
-      else
-      {
-         const auto laneNum = commit.getLanesCount();
-         const auto activeLane = commit.getActiveLane();
-         const auto activeColor
-             = GitQlientStyles::getBranchColorAt(activeLane % GitQlientStyles::getTotalBranchColors());
-         auto x1 = 0;
-         auto isSet = false;
-         auto laneHeadPresent = false;
-         auto mergeColor = GitQlientStyles::getBranchColorAt((laneNum - 1) % GitQlientStyles::getTotalBranchColors());
-
-         for (auto i = laneNum - 1, x2 = LANE_WIDTH * laneNum; i >= 0; --i, x2 -= LANE_WIDTH)
-         {
-            x1 = x2 - LANE_WIDTH;
+void RepositoryViewDelegate::paintGraphLanes(QPainter *p, LaneGlyphAtlas::Key key, const LaneRow &lanes,
+                                             bool showAll) const
+{
+   const auto laneNum = lanes.count();
+   auto activeLane = -1;
 
-            auto currentLane = commit.getLane(i);
+   for (auto i = 0; i < laneNum && activeLane == -1; ++i)
+   {
+      if (lanes.at(i).isActive())
+         activeLane = i;
+   }
 
-            if (!laneHeadPresent && i < laneNum - 1)
-            {
-               auto prevLane = commit.getLane(i + 1);
-               laneHeadPresent
-                   = prevLane.isHead() || prevLane.equals(LaneType::JOIN_R) || prevLane.equals(LaneType::JOIN_L);
-            }
+   const auto activeColor = activeLane % GitQlientStyles::getTotalBranchColors();
+   auto x1 = 0;
+   auto isSet = false;
+   auto laneHeadPresent = false;
+   auto mergeColor = (laneNum - 1) % GitQlientStyles::getTotalBranchColors();
 
-            if (!currentLane.equals(LaneType::EMPTY))
-            {
-               auto color = activeColor;
+   // The lanes beyond the maximum are not painted, but they are still read since the lanes on their left depend on
+   // them. The active lane is painted in the place of the overflow glyph if it's one of them.
+   const auto visibleLanes = !showAll && laneNum > mMaxLanes ? mMaxLanes - 1 : laneNum;
 
-               if (i != activeLane)
-                  color = GitQlientStyles::getBranchColorAt(i % GitQlientStyles::getTotalBranchColors());
+   if (visibleLanes < laneNum && activeLane < visibleLanes)
+      paintOverflowGlyph(p, LANE_WIDTH * visibleLanes, key.rowHeight);
 
-               if (!isSet)
-                  mergeColor = getMergeColor(currentLane, commit, i, color, isSet);
+   for (auto i = laneNum - 1, x2 = LANE_WIDTH * laneNum; i >= 0; --i, x2 -= LANE_WIDTH)
+   {
+      x1 = i < visibleLanes ? x2 - LANE_WIDTH : LANE_WIDTH * visibleLanes;
 
-               paintGraphLane(p, currentLane, laneHeadPresent, x1, x2, color, activeColor, mergeColor, false,
-                              commit.hasChilds());
+      const auto currentLane = lanes.at(i);
 
-               if (mView->hasActiveFilter())
-                  break;
-            }
-         }
+      if (!laneHeadPresent && i < laneNum - 1)
+      {
+         const auto prevLane = lanes.at(i + 1);
+         laneHeadPresent = prevLane.isHead() || prevLane.equals(LaneType::JOIN_R) || prevLane.equals(LaneType::JOIN_L);
+      }
+
+      if (!currentLane.equals(LaneType::EMPTY) && (i < visibleLanes || i == activeLane))
+      {
+         auto color = activeColor;
+
+         if (i != activeLane)
+            color = i % GitQlientStyles::getTotalBranchColors();
+
+         if (!isSet)
+            mergeColor = getMergeColor(currentLane, lanes, i, color, isSet);
+
+         key.type = currentLane.getType();
+         key.color = color;
+         key.mergeColor = mergeColor;
+         key.headPresent = laneHeadPresent;
+         paintGraphGlyph(p, key, x1);
       }
    }
-   p->restore();
 }
 
-void RepositoryViewDelegate::paintLog(QPainter *p, const QStyleOptionViewItem &opt, const CommitInfo &commit,
-                                      const QString &text) const
+void RepositoryViewDelegate::paintOverflowGlyph(QPainter *p, int x1, int rowHeight) const
 {
-   const auto sha = commit.sha();
+   LaneGlyphAtlas::Key key;
+   key.overflow = true;
+   key.rowHeight = rowHeight;
+   key.devicePixelRatio = p->device()->devicePixelRatioF();
 
-   if (sha.isEmpty())
-      return;
+   paintGraphGlyph(p, key, x1);
+}
 
+int RepositoryViewDelegate::getLanesCount(const QModelIndex &index) const
+{
+   if (mView->hasActiveFilter())
+   {
+      const auto proxy = qobject_cast<const ShaFilterProxyModel *>(index.model());
+      LaneRow lanes;
+      auto hasChilds = false;
+
+      return proxy && proxy->getLanes(index.row(), lanes, hasChilds) ? lanes.count() : 1;
+   }
+
+   return mCache->getCommitRow(index.row()).getLanesCount();
+}
+
+void RepositoryViewDelegate::paintLog(QPainter *p, const QStyleOptionViewItem &opt, const CommitRow &commit,
+                                      const QString &text) const
+{
    auto offset = 0;
 
    if (mGitServerCache)
@@ -430,7 +565,7 @@ void RepositoryViewDelegate::paintLog(QPainter *p, const QStyleOptionViewItem &o
       if (offset == 0)
          offset = 5;
 
-      paintTagBranch(p, opt, offset, sha);
+      paintTagBranch(p, opt, offset, commit);
    }
 
    auto newOpt = opt;
@@ -445,11 +580,10 @@ void RepositoryViewDelegate::paintLog(QPainter *p, const QStyleOptionViewItem &o
 }
 
 void RepositoryViewDelegate::paintTagBranch(QPainter *painter, QStyleOptionViewItem o, int &startPoint,
-                                            const QString &sha) const
+                                            const CommitRow &commit) const
 {
    QMap<QString, QColor> markValues;
    const auto currentBranch = mGit->getCurrentBranch();
-   const auto commit = mCache->getCommitInfo(sha);
 
    if ((currentBranch.isEmpty() || currentBranch == "HEAD"))
    {
@@ -23,14 +23,17 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <Lane.h>
+#include <LaneGlyphAtlas.h>
+
 #include <QStyledItemDelegate>
 #include <QDateTime>
+#include <QSet>
 
 class CommitHistoryView;
 class GitCache;
 class GitBase;
-class Lane;
-class CommitInfo;
+class CommitRow;
 class GitServerCache;
 
 namespace GitServer
@@ -76,6 +79,13 @@ public:
     * @return QSize returns the size of a row.
     */
    QSize sizeHint(const QStyleOptionViewItem &, const QModelIndex &) const override;
+   /**
+    * @brief Sets the maximum number of lanes painted in a row. The rest are folded into an overflow glyph that shows
+    * all the lanes of the row when it's clicked.
+    *
+    * @param maxLanes The maximum number of lanes, including the overflow glyph.
+    */
+   void setMaxLanes(int maxLanes);
 
 protected:
    bool editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option,
@@ -88,6 +98,10 @@ private:
    CommitHistoryView *mView = nullptr;
    int diffTargetRow = -1;
    int mColumnPressed = -1;
+   mutable LaneGlyphAtlas mGlyphAtlas;
+   int mMaxLanes = 0;
+   // The commits which rows show all their lanes.
+   QSet<QString> mExpandedShas;
 
    /**
     * @brief Paints the log column. This method is in charge of painting the commit message as well as tags or
@@ -97,15 +111,38 @@ private:
     * @param o The style options of the item.
     * @param i The index with the item data.
     */
-   void paintLog(QPainter *p, const QStyleOptionViewItem &o, const CommitInfo &commit, const QString &text) const;
+   void paintLog(QPainter *p, const QStyleOptionViewItem &o, const CommitRow &commit, const QString &text) const;
    /**
     * @brief Method that sets up the configuration to paint the lane for the commit graph representation.
     *
     * @param p The painter device.
     * @param o The style options of the item.
     * @param index The index with the item data.
+    * @param commit The commit of the row.
+    */
+   void paintGraph(QPainter *p, const QStyleOptionViewItem &o, const QModelIndex &index,
+                   const CommitRow &commit) const;
+   /**
+    * @brief Paints all the lanes of a row.
+    *
+    * @param p The painter device.
+    * @param key The glyph key with the fields that are the same for all the lanes of the row.
+    * @param lanes The lanes of the row.
+    * @param showAll Paints all the lanes instead of folding the ones beyond the maximum.
+    */
+   void paintGraphLanes(QPainter *p, LaneGlyphAtlas::Key key, const LaneRow &lanes, bool showAll) const;
+   /**
+    * @brief Paints the glyph that replaces the lanes beyond the maximum.
+    *
+    * @param p The painter device.
+    * @param x1 X coordinate where the glyph starts.
+    * @param rowHeight The height of the row.
+    */
+   void paintOverflowGlyph(QPainter *p, int x1, int rowHeight) const;
+   /**
+    * @brief Returns the number of lanes of the row of the index, as they are painted in the view.
     */
-   void paintGraph(QPainter *p, const QStyleOptionViewItem &o, const CommitInfo &commit) const;
+   int getLanesCount(const QModelIndex &index) const;
 
    /**
     * @brief Specialization method called by @ref paintGrapth that does the actual lane painting.
@@ -115,14 +152,23 @@ private:
     * @param laneHeadPresent Tells the method if the lane contains a head.
     * @param x1 X coordinate where the painting starts
     * @param x2 X coordinate where the painting ends
+    * @param rowHeight The height of the row.
     * @param col Color of the lane
     * @param activeCol Color of the active lane
     * @param mergeColor Color of the lane where the merge comes from in case the commit is a end-merge point.
     * @param isWip Tells the method if it's the WIP commit so it's painted differently.
     */
-   void paintGraphLane(QPainter *p, const Lane &type, bool laneHeadPresent, int x1, int x2, const QColor &col,
-                       const QColor &activeCol, const QColor &mergeColor, bool isWip = false,
+   void paintGraphLane(QPainter *p, const Lane &type, bool laneHeadPresent, int x1, int x2, int rowHeight,
+                       const QColor &col, const QColor &activeCol, const QColor &mergeColor, bool isWip = false,
                        bool hasChilds = true) const;
+   /**
+    * @brief Draws a lane from the glyph atlas, painting it first with @ref paintGraphLane if it's not there.
+    *
+    * @param p The painter device.
+    * @param key The lane to paint.
+    * @param x1 X coordinate where the lane starts.
+    */
+   void paintGraphGlyph(QPainter *p, const LaneGlyphAtlas::Key &key, int x1) const;
 
    /**
     * @brief Specialized method that paints a tag in the commit message column.
@@ -130,9 +176,10 @@ private:
     * @param painter The painter device.
     * @param opt The style options of the item.
     * @param startPoint The starting X coordinate for the tag.
-    * @param sha The SHA reference to paint. It can be local branch, remote branch, tag or it could be detached.
+    * @param commit The commit which references are painted. It can be local branch, remote branch, tag or it could be
+    * detached.
     */
-   void paintTagBranch(QPainter *painter, QStyleOptionViewItem opt, int &startPoint, const QString &sha) const;
+   void paintTagBranch(QPainter *painter, QStyleOptionViewItem opt, int &startPoint, const CommitRow &commit) const;
 
    /**
     * @brief Specialized method that paints a tag in the commit message column.
@@ -149,13 +196,14 @@ private:
     * @brief getMergeColor Returns the color to be used for painting the external circle of the node. This methods
     * searches the origin of the merge and uses the same lane color.
     * @param currentLane The current lane type.
-    * @param commit The current commit.
+    * @param lanes The lanes of the current commit.
     * @param currentLaneIndex The current index of the lane.
-    * @param defaultColor The default color in case it's not a merge.
+    * @param defaultColor The index of the default branch color in case it's not a merge.
     * @param isSet Boolean used as a shortcut. If the current iteration is a merge it will change the value for the
     * following lanes.
-    * @return Returns the color of the lane that merges into the current node, otherwise it returns @p defaultColor.
+    * @return Returns the index of the branch color of the lane that merges into the current node, otherwise it
+    * returns @p defaultColor.
     */
-   QColor getMergeColor(const Lane &currentLane, const CommitInfo &commit, int currentLaneIndex,
-                        const QColor &defaultColor, bool &isSet) const;
+   int getMergeColor(const Lane &currentLane, const LaneRow &lanes, int currentLaneIndex, int defaultColor,
+                     bool &isSet) const;
 };
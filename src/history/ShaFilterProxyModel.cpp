@@ -2,14 +2,276 @@
 
 #include <CommitHistoryColumns.h>
 
-ShaFilterProxyModel::ShaFilterProxyModel(QObject *parent)
-   : QSortFilterProxyModel(parent)
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+// The time without new rows before their lanes are calculated.
+const int LANES_DELAY_MS = 300;
+}
+
+ShaFilterProxyModel::ShaFilterProxyModel(const QSharedPointer<GitCache> &cache, QObject *parent)
+   : QAbstractProxyModel(parent)
+   , mCache(cache)
+   , mLanesTimer(new QTimer(this))
+{
+   mLanesTimer->setSingleShot(true);
+   mLanesTimer->setInterval(LANES_DELAY_MS);
+   connect(mLanesTimer, &QTimer::timeout, this, [this]() { updateLanes(true); });
+}
+
+ShaFilterProxyModel::~ShaFilterProxyModel()
+{
+   if (mLanesCanceled)
+      *mLanesCanceled = true;
+
+   mLanesPool.waitForDone();
+}
+
+void ShaFilterProxyModel::setSourceModel(QAbstractItemModel *model)
+{
+   if (const auto previous = sourceModel())
+      disconnect(previous, nullptr, this, nullptr);
+
+   QAbstractProxyModel::beginResetModel();
+   QAbstractProxyModel::setSourceModel(model);
+   resolveShas();
+   QAbstractProxyModel::endResetModel();
+
+   updateLanes();
+
+   if (!model)
+      return;
+
+   // The history only grows at the end or is reset, so any other change of the source is handled as a reset.
+   connect(model, &QAbstractItemModel::modelAboutToBeReset, this, &ShaFilterProxyModel::beginResetModel);
+   connect(model, &QAbstractItemModel::modelReset, this, &ShaFilterProxyModel::endResetModel);
+   connect(model, &QAbstractItemModel::layoutAboutToBeChanged, this, &ShaFilterProxyModel::beginResetModel);
+   connect(model, &QAbstractItemModel::layoutChanged, this, &ShaFilterProxyModel::endResetModel);
+   connect(model, &QAbstractItemModel::dataChanged, this, &ShaFilterProxyModel::onSourceDataChanged);
+   connect(model, &QAbstractItemModel::headerDataChanged, this, &ShaFilterProxyModel::headerDataChanged);
+   connect(model, &QAbstractItemModel::rowsInserted, this, [this]() {
+      // The new rows can contain SHAs that were not loaded yet.
+      if (!mFilterByRows && mRows.count() < mAcceptedShas.count())
+      {
+         beginResetModel();
+         endResetModel();
+      }
+   });
+}
+
+void ShaFilterProxyModel::setAcceptedSha(const QStringList &acceptedShaList)
+{
+   mAcceptedShas = acceptedShaList;
+   mFilterByRows = false;
+}
+
+void ShaFilterProxyModel::setAcceptedRows(const QVector<int> &rows)
+{
+   QAbstractProxyModel::beginResetModel();
+   mAcceptedShas.clear();
+   mFilterByRows = true;
+   mRows = rows;
+   std::sort(mRows.begin(), mRows.end());
+   mRows.erase(std::unique(mRows.begin(), mRows.end()), mRows.end());
+   QAbstractProxyModel::endResetModel();
+
+   updateLanes();
+}
+
+void ShaFilterProxyModel::addAcceptedRows(const QVector<int> &rows)
 {
+   auto newRows = rows;
+   std::sort(newRows.begin(), newRows.end());
+
+   // The rows that go to the same position are inserted as a block. The rows of a chunk of the history are usually
+   // a single block.
+   for (auto i = 0; i < newRows.count();)
+   {
+      const auto iter = std::lower_bound(mRows.cbegin(), mRows.cend(), newRows.at(i));
+      const auto position = static_cast<int>(iter - mRows.cbegin());
+      const auto next = position < mRows.count() ? mRows.at(position) : std::numeric_limits<int>::max();
+      auto end = i;
+
+      while (end < newRows.count() && newRows.at(end) < next)
+         ++end;
+
+      // Rows that are already accepted are skipped.
+      if (end == i)
+      {
+         ++i;
+         continue;
+      }
+
+      auto block = QVector<int>(newRows.cbegin() + i, newRows.cbegin() + end);
+      block.erase(std::unique(block.begin(), block.end()), block.end());
+
+      beginInsertRows(QModelIndex(), position, position + block.count() - 1);
+      mRows.insert(position, block.count(), 0);
+      std::copy(block.cbegin(), block.cend(), mRows.begin() + position);
+      endInsertRows();
+
+      i = end;
+   }
+
+   // The filters add the rows by chunks, the lanes are calculated once when they stop arriving.
+   mLanesTimer->start();
 }
 
-bool ShaFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+void ShaFilterProxyModel::endResetModel()
 {
-   const auto shaIndex = sourceModel()->index(sourceRow, static_cast<int>(CommitHistoryColumns::Sha), sourceParent);
-   const auto sha = sourceModel()->data(shaIndex).toString();
-   return mAcceptedShas.contains(sha);
+   resolveShas();
+   QAbstractProxyModel::endResetModel();
+
+   updateLanes();
+}
+
+QModelIndex ShaFilterProxyModel::index(int row, int column, const QModelIndex &parent) const
+{
+   if (parent.isValid() || row < 0 || row >= mRows.count() || column < 0 || column >= columnCount())
+      return QModelIndex();
+
+   return createIndex(row, column);
+}
+
+QModelIndex ShaFilterProxyModel::parent(const QModelIndex &) const
+{
+   return QModelIndex();
+}
+
+int ShaFilterProxyModel::rowCount(const QModelIndex &parent) const
+{
+   return !parent.isValid() ? mRows.count() : 0;
+}
+
+int ShaFilterProxyModel::columnCount(const QModelIndex &parent) const
+{
+   return sourceModel() && !parent.isValid() ? sourceModel()->columnCount() : 0;
+}
+
+bool ShaFilterProxyModel::hasChildren(const QModelIndex &parent) const
+{
+   return !parent.isValid();
+}
+
+QModelIndex ShaFilterProxyModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+   if (!sourceModel() || !proxyIndex.isValid() || proxyIndex.row() >= mRows.count())
+      return QModelIndex();
+
+   return sourceModel()->index(mRows.at(proxyIndex.row()), proxyIndex.column());
+}
+
+QModelIndex ShaFilterProxyModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+   if (!sourceIndex.isValid())
+      return QModelIndex();
+
+   const auto iter = std::lower_bound(mRows.cbegin(), mRows.cend(), sourceIndex.row());
+
+   if (iter == mRows.cend() || *iter != sourceIndex.row())
+      return QModelIndex();
+
+   return index(static_cast<int>(iter - mRows.cbegin()), sourceIndex.column());
+}
+
+void ShaFilterProxyModel::resolveShas()
+{
+   if (!mFilterByRows)
+      mRows = mCache->getCommitRows(mAcceptedShas);
+}
+
+bool ShaFilterProxyModel::getLanes(int row, LaneRow &lanes, bool &hasChilds) const
+{
+   if (row < 0 || row >= mRows.count())
+      return false;
+
+   // The lanes can belong to fewer rows than the accepted ones, so they are found by the row of the source.
+   const auto iter = std::lower_bound(mLanesRows.cbegin(), mLanesRows.cend(), mRows.at(row));
+
+   if (iter == mLanesRows.cend() || *iter != mRows.at(row))
+      return false;
+
+   const auto position = static_cast<int>(iter - mLanesRows.cbegin());
+
+   if (position >= mLanes.lanes.count() || mLanes.lanes.at(position).isEmpty())
+      return false;
+
+   const auto &rowLanes = mLanes.lanes.at(position);
+
+   lanes.clear();
+   lanes.append(rowLanes.constData(), rowLanes.count());
+   hasChilds = mLanes.hasChilds.at(position);
+
+   return true;
+}
+
+void ShaFilterProxyModel::updateLanes(bool keepLanes)
+{
+   mLanesTimer->stop();
+
+   if (mLanesCanceled)
+      *mLanesCanceled = true;
+
+   // After a reset the lanes of the previous rows don't match the new ones, the view paints the rows without them
+   // meanwhile.
+   if (!keepLanes)
+   {
+      mLanes = GitCache::SubgraphLanes();
+      mLanesRows.clear();
+   }
+
+   // The rows are taken with the graph they belong to now, the loader can publish another one while the lanes are
+   // calculated.
+   const auto canceled = std::make_shared<std::atomic_bool>(false);
+   const auto generation = ++mLanesGeneration;
+   const auto snapshot = mCache->getSnapshot();
+   const auto rows = mRows;
+
+   mLanesCanceled = canceled;
+
+   if (rows.isEmpty())
+      return;
+
+   QtConcurrent::run(&mLanesPool, [this, snapshot, rows, canceled, generation]() {
+      auto lanes = GitCache::calculateSubgraphLanes(*snapshot, rows, *canceled);
+
+      if (*canceled)
+         return;
+
+      // The proxy waits for the pool before being destroyed, and the call is dropped if it's destroyed before it's
+      // delivered.
+      QMetaObject::invokeMethod(
+          this,
+          [this, generation, rows, lanes = std::move(lanes)]() {
+             if (generation != mLanesGeneration)
+                return;
+
+             mLanes = lanes;
+             mLanesRows = rows;
+
+             const auto column = static_cast<int>(CommitHistoryColumns::Graph);
+             emit dataChanged(index(0, column), index(mRows.count() - 1, column));
+          },
+          Qt::QueuedConnection);
+   });
+}
+
+void ShaFilterProxyModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                              const QVector<int> &roles)
+{
+   const auto first = std::lower_bound(mRows.cbegin(), mRows.cend(), topLeft.row());
+   const auto last = std::upper_bound(first, mRows.cend(), bottomRight.row());
+
+   if (first != last)
+   {
+      const auto firstRow = static_cast<int>(first - mRows.cbegin());
+      const auto lastRow = static_cast<int>(last - mRows.cbegin()) - 1;
+
+      emit dataChanged(index(firstRow, topLeft.column()), index(lastRow, bottomRight.column()), roles);
+   }
 }
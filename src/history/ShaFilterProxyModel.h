@@ -1,5 +1,6 @@
 #pragma once
 
+
 /****************************************************************************************
  ** GitQlient is an application to manage and operate one or several Git repositories. With
  ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
@@ -23,14 +24,34 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
-#include <QSortFilterProxyModel>
+#include <GitCache.h>
+
+#include <QAbstractProxyModel>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+class QTimer;
 
 /**
- * @brief The ShaFilterProxyModel class is an overload of the QSortFilterProxyModel that takes a list of shas to act as
- * a filter between a view and a QAbstractiItemModel.
+ * @brief The ShaFilterProxyModel class is a proxy between a view and the model of the history that only shows a set of
+ * commits. The commits can be given by SHA or directly by row.
  *
+ * The SHAs are resolved to rows through the index of the cache when they are set, and the accepted rows are kept
+ * sorted, so the mapping between the proxy and the source is a lookup or a binary search instead of checking every row
+ * of the source.
+ *
+ * The rows keep the lanes of the whole graph, that are meaningless when most of the commits are hidden. So the proxy
+ * calculates in the background the lanes of the accepted commits as a graph on their own. While the rows are added
+ * the calculation waits for them to stop arriving, and the previous lanes are shown meanwhile.
+ *
+ * @class ShaFilterProxyModel ShaFilterProxyModel.h "ShaFilterProxyModel.h"
  */
-class ShaFilterProxyModel : public QSortFilterProxyModel
+class ShaFilterProxyModel : public QAbstractProxyModel
 {
    Q_OBJECT
 
@@ -38,41 +59,97 @@ public:
    /**
     * @brief Default constructor.
     *
+    * @param cache The internal cache for the current repository, used to resolve the SHAs.
     * @param parent The parent widget if needed.
     */
-   explicit ShaFilterProxyModel(QObject *parent = nullptr);
+   explicit ShaFilterProxyModel(const QSharedPointer<GitCache> &cache, QObject *parent = nullptr);
+
+   /**
+    * @brief Sets the model that is filtered.
+    *
+    * @param sourceModel The source model.
+    */
+   void setSourceModel(QAbstractItemModel *sourceModel) override;
 
    /**
-    * @brief Sets the list of accepted SHAs that will be shown in the source model.
+    * @brief Sets the list of accepted SHAs that will be shown in the source model. They are resolved when the source
+    * model is set or in @ref endResetModel, so it must be called before one of them.
     *
     * @param acceptedShaList The SHAs list.
     */
-   void setAcceptedSha(const QStringList &acceptedShaList) { mAcceptedShas = acceptedShaList; }
+   void setAcceptedSha(const QStringList &acceptedShaList);
    /**
-    * @brief Starts the reset of the model
+    * @brief Filters by the rows of the source model instead of by SHA. The filter is applied immediately.
     *
+    * @param rows The accepted rows.
     */
-   void beginResetModel() { QSortFilterProxyModel::beginResetModel(); }
+   void setAcceptedRows(const QVector<int> &rows);
    /**
-    * @brief Ends the reset of the model.
+    * @brief Adds rows to the ones accepted by @ref setAcceptedRows. It's used to show the results of a filter while
+    * they are being found. The lanes are calculated again once no rows are added for a while.
     *
+    * @param rows The new accepted rows.
     */
-   void endResetModel() { QSortFilterProxyModel::endResetModel(); }
-
-protected:
+   void addAcceptedRows(const QVector<int> &rows);
    /**
-    * @brief This method is the actual filter functionality. Given the source row and the source index it retrieves the
-    * sha and checks if it's among the accepted SHAs in the list.
+    * @brief The accepted rows of the source model, sorted.
+    */
+   QVector<int> acceptedRows() const { return mRows; }
+   /**
+    * @brief Returns the lanes of a row calculated only with the accepted commits.
     *
-    * @param sourceRow The source row number.
-    * @param sourceParent The source index.
-    * @return bool Returns true if the source row should be shown in the view.
+    * @param row The row of the proxy.
+    * @param lanes Output with the lanes of the row.
+    * @param hasChilds Output that tells if the commit has children among the accepted commits.
+    * @return True if the lanes are calculated. They are not while they are being calculated in the background.
     */
-   bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+   bool getLanes(int row, LaneRow &lanes, bool &hasChilds) const;
+   /**
+    * @brief Starts the reset of the model
+    *
+    */
+   void beginResetModel() { QAbstractProxyModel::beginResetModel(); }
+   /**
+    * @brief Ends the reset of the model. The SHAs are resolved again, since their rows can change with the history.
+    *
+    */
+   void endResetModel();
+
+   ~ShaFilterProxyModel() override;
+
+   QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+   QModelIndex parent(const QModelIndex &child) const override;
+   int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+   int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+   bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+   QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+   QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
 
 private:
+   QSharedPointer<GitCache> mCache;
+   QStringList mAcceptedShas;
+   QVector<int> mRows;
+   bool mFilterByRows = false;
+   GitCache::SubgraphLanes mLanes;
+   // The accepted rows when the lanes were calculated. They can be fewer than the current ones.
+   QVector<int> mLanesRows;
+   QTimer *mLanesTimer = nullptr;
+   std::shared_ptr<std::atomic_bool> mLanesCanceled;
+   QThreadPool mLanesPool;
+   int mLanesGeneration = 0;
+
    /**
-    * @brief mAcceptedShas List of accepted shas.
+    * @brief Resolves the accepted SHAs to rows of the source model.
     */
-   QStringList mAcceptedShas;
+   void resolveShas();
+   /**
+    * @brief Starts the calculation of the lanes of the accepted rows and cancels the previous one.
+    *
+    * @param keepLanes Keeps the lanes of the rows that were already accepted until the new ones are calculated.
+    */
+   void updateLanes(bool keepLanes = false);
+   /**
+    * @brief Forwards the changes of the source to the proxy.
+    */
+   void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles);
 };